@@ -0,0 +1,200 @@
+#include "AssetCache.h"
+#include "ObjLoader.h"
+#include "BinaryMesh.h"
+#include "MaterialLoader.h"
+#include "MaterialTable.h"
+#include "AsyncLoader.h"
+
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <cctype>
+#include <GL/glew.h>
+
+// S tocado na thread do GL (pedidos e concluses chegam por ela)
+struct MeshEntry {
+    Mesh* mesh = nullptr;
+    bool resident = false;
+    bool loading = false;   // job na fila ou rodando
+    int refs = 0;
+    std::vector<Obj3D*> waiting;
+};
+
+// Tocado pela thread de carregamento tambm
+struct MaterialEntry {
+    std::map<std::string, Material*> materials;
+    int refs = 0;
+};
+
+static std::map<std::string, MeshEntry> meshCache;
+static std::map<std::string, MaterialEntry> materialCache;
+static std::mutex materialMutex;
+
+std::string canonicalPath(const std::string& path)
+{
+    std::string p = path;
+    for (char& ch : p)
+        if (ch == '\\') ch = '/';
+#ifdef _WIN32
+    for (char& ch : p)
+        ch = (char)tolower((unsigned char)ch);   // sistema de arquivos sem distino de caixa
+#endif
+
+    bool absolute = !p.empty() && p[0] == '/';
+    std::vector<std::string> parts;
+    size_t begin = 0;
+    while (begin <= p.size())
+    {
+        size_t end = p.find('/', begin);
+        if (end == std::string::npos) end = p.size();
+        std::string part = p.substr(begin, end - begin);
+        begin = end + 1;
+
+        if (part.empty() || part == ".") continue;
+        if (part == ".." && !parts.empty() && parts.back() != "..") parts.pop_back();
+        else parts.push_back(part);
+    }
+
+    std::string result = absolute ? "/" : "";
+    for (size_t i = 0; i < parts.size(); i++)
+        result += (i ? "/" : "") + parts[i];
+    return result;
+}
+
+// Malha sem dono: apaga ela e devolve os .mtl que pediu
+static void destroyMesh(Mesh* mesh)
+{
+    for (const std::string& lib : mesh->mtlLibs)
+        releaseMaterials(lib);
+    delete mesh;
+}
+
+// Thread de carregamento: usa o cache binrio (.smesh) quando ele ainda
+// corresponde ao .obj; seno faz o parsing completo (que grava um cache novo).
+// Os uploads de GL ficam na fila; a malha s fica visvel quando a tarefa de
+// concluso, postada depois deles, roda.
+static void loadMeshJob(const std::string& key)
+{
+    Mesh* mesh = loadBinaryMesh(key);
+    if (!mesh) {
+        Obj3D* obj = loadOBJ(key);
+        if (obj) {
+            mesh = obj->mesh;
+            delete obj;
+        }
+    }
+
+    postGLTask([key, mesh] {
+        auto it = meshCache.find(key);
+
+        // todos os pedidos foram liberados antes do fim da carga, ou outra
+        // carga do mesmo arquivo (pedido depois da liberao) chegou antes
+        if (it == meshCache.end() || it->second.resident) {
+            if (mesh) destroyMesh(mesh);
+            return;
+        }
+        MeshEntry& entry = it->second;
+
+        // a entrada sai com as referncias de quem esperava (os objetos
+        // ficam sem malha); um pedido novo tenta carregar de novo
+        if (!mesh) {
+            std::cerr << "[Assets] Falha ao carregar malha: " << key << " ("
+                << entry.waiting.size() << " objeto(s) sem malha)" << std::endl;
+            meshCache.erase(it);
+            return;
+        }
+
+        entry.mesh = mesh;
+        entry.resident = true;
+        entry.loading = false;
+        for (Obj3D* obj : entry.waiting)
+            obj->mesh = mesh;
+        entry.waiting.clear();
+    });
+}
+
+void requestMesh(const std::string& path, Obj3D* target)
+{
+    std::string key = canonicalPath(path);
+    MeshEntry& entry = meshCache[key];
+    entry.refs++;
+
+    if (entry.resident) {
+        std::cout << "[Assets] Reusando malha: " << key << " (refs=" << entry.refs << ")\n";
+        target->mesh = entry.mesh;
+        return;
+    }
+
+    entry.waiting.push_back(target);
+    if (!entry.loading) {
+        entry.loading = true;
+        submitLoadJob([key] { loadMeshJob(key); });
+    }
+}
+
+void releaseMesh(Obj3D* target)
+{
+    if (!target) return;
+
+    for (auto it = meshCache.begin(); it != meshCache.end(); ++it)
+    {
+        MeshEntry& entry = it->second;
+        if (target->mesh) {
+            if (entry.mesh != target->mesh) continue;
+        }
+        else {
+            // ainda carregando: sai da lista de espera
+            auto w = std::find(entry.waiting.begin(), entry.waiting.end(), target);
+            if (w == entry.waiting.end()) continue;
+            entry.waiting.erase(w);
+        }
+
+        target->mesh = nullptr;
+        if (--entry.refs > 0) return;
+
+        // sem a entrada, a concluso de uma carga em andamento apaga a malha
+        if (entry.mesh) destroyMesh(entry.mesh);
+        meshCache.erase(it);
+        return;
+    }
+}
+
+std::map<std::string, Material*> acquireMaterials(const std::string& path)
+{
+    std::string key = canonicalPath(path);
+
+    // o lock cobre a leitura do .mtl: quem pede o mesmo arquivo em paralelo
+    // espera e recebe a mesma instncia
+    std::lock_guard<std::mutex> lock(materialMutex);
+    MaterialEntry& entry = materialCache[key];
+    if (entry.refs++ > 0) {
+        std::cout << "[Assets] Reusando MTL: " << key << " (refs=" << entry.refs << ")\n";
+        return entry.materials;
+    }
+
+    // texturas sob demanda: touchTexture no primeiro draw visvel
+    entry.materials = parseMTL(key);
+    for (auto& kv : entry.materials)
+        registerMaterial(kv.second);
+    return entry.materials;
+}
+
+void releaseMaterials(const std::string& path)
+{
+    std::map<std::string, Material*> materials;
+    {
+        std::lock_guard<std::mutex> lock(materialMutex);
+        auto it = materialCache.find(canonicalPath(path));
+        if (it == materialCache.end() || --it->second.refs > 0) return;
+        materials.swap(it->second.materials);
+        materialCache.erase(it);
+    }
+
+    for (auto& kv : materials)
+    {
+        unregisterMaterial(kv.second);
+        releaseTexture(kv.second->texture);
+        delete kv.second;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <map>
+#include "Mesh.h"
+#include "Material.h"
+#include "Obj3D.h"
+
+// Cache compartilhado de malhas e bibliotecas de materiais, indexado pelo
+// caminho normalizado. Cada arquivo  carregado uma nica vez; os pedidos
+// seguintes devolvem a mesma instncia e s incrementam a contagem de
+// referncias. A ltima liberao apaga os objetos de GPU.
+
+// Caminho cannico usado como chave dos caches: separadores '/', sem "."
+// nem "dir/..", e em minsculas no Windows.
+std::string canonicalPath(const std::string& path);
+
+// Pede a malha de `path` para `target` (thread do GL). O parsing roda na
+// thread de carregamento; target->mesh  preenchido quando a malha est
+// residente na GPU (continua nullptr em caso de falha, e um pedido
+// posterior do mesmo arquivo tenta de novo).
+void requestMesh(const std::string& path, Obj3D* target);
+
+// Devolve a referncia de `target`, com a malha j carregada ou ainda a
+// caminho, e zera target->mesh. A ltima apaga a malha e solta os .mtl.
+void releaseMesh(Obj3D* target);
+
+// Materiais de um .mtl, compartilhados entre malhas. Pode ser chamado de
+// qualquer thread; as texturas s carregam quando desenhadas (touchTexture).
+std::map<std::string, Material*> acquireMaterials(const std::string& path);
+void releaseMaterials(const std::string& path);
@@ -2,22 +2,31 @@
 #define ASSETMANAGER_H
 
 #include <GL\glew.h>
-#include <SOIL.h>
+#include "TextureCache.h"
 
 #include <string>
 
 namespace AssetManager
 {
 
-	static unsigned char* LoadImage(char* path) {
-		int width, height;
-		unsigned char* image;
+	// Textura da imagem pelo cache de texturas: comprimida em BC1/BC3 (com o
+	// .dds ao lado da imagem) quando o driver suporta, enviada uma vez s.
+	static Texture* LoadImage(const char* path) {
+		Texture* tex = acquireTexture(path);
+		uploadTexture(tex);
+		return tex;
+	};
 
-		image = SOIL_load_image(path, &width, &height, 0, SOIL_LOAD_RGBA);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		SOIL_free_image_data(image);
+	// Oramento de VRAM das texturas (0 = sem limite); as menos usadas
+	// recentemente perdem mipmaps ou saem da GPU at caber.
+	static void SetTextureBudget(size_t bytes) {
+		setTextureBudget(bytes);
+	};
 
-		return nullptr;
+	// Cache, residncia e oramento das texturas, para dimensionar o
+	// oramento de cada cena.
+	static void PrintTextureReport() {
+		printTextureCacheStats();
 	};
 
 };
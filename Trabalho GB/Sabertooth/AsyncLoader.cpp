@@ -0,0 +1,139 @@
+#include "AsyncLoader.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <atomic>
+
+static std::thread worker;
+static std::thread::id glThread;
+static bool running = false;
+
+static std::mutex jobMutex;
+static std::condition_variable jobReady;
+static std::deque<std::function<void()>> jobs;
+static bool stopping = false;
+
+static std::mutex taskMutex;
+static std::deque<std::function<void()>> glTasks;
+
+static std::atomic<size_t> pending(0);
+static std::atomic<bool> workerDone(false);
+
+static void workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                workerDone = true;
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        job();
+        pending--;
+    }
+}
+
+void startAsyncLoader()
+{
+    if (running) return;
+
+    glThread = std::this_thread::get_id();
+    stopping = false;
+    workerDone = false;
+    running = true;
+    worker = std::thread(workerLoop);
+}
+
+void stopAsyncLoader()
+{
+    if (!running) return;
+
+    {
+        // jobs que ainda no comearam so descartados
+        std::lock_guard<std::mutex> lock(jobMutex);
+        pending -= jobs.size();
+        jobs.clear();
+        stopping = true;
+    }
+    jobReady.notify_one();
+
+    // o job em andamento pode estar esperando uma tarefa de GL
+    while (!workerDone) {
+        runGLTasks(1e9);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    worker.join();
+    running = false;
+
+    // o que a thread deixou para o GL ainda precisa rodar (ou ser descartado
+    // junto com o contexto); roda tudo para no vazar recursos
+    runGLTasks(1e9);
+}
+
+void submitLoadJob(std::function<void()> job)
+{
+    if (!running) {
+        job();
+        return;
+    }
+
+    pending++;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.push_back(std::move(job));
+    }
+    jobReady.notify_one();
+}
+
+void postGLTask(std::function<void()> task)
+{
+    if (!running || std::this_thread::get_id() == glThread) {
+        task();
+        return;
+    }
+
+    pending++;
+    std::lock_guard<std::mutex> lock(taskMutex);
+    glTasks.push_back(std::move(task));
+}
+
+int runGLTasks(double budgetMs)
+{
+    auto start = std::chrono::steady_clock::now();
+    int ran = 0;
+
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(taskMutex);
+            if (glTasks.empty()) break;
+            task = std::move(glTasks.front());
+            glTasks.pop_front();
+        }
+
+        task();
+        pending--;
+        ran++;
+
+        std::chrono::duration<double, std::milli> spent = std::chrono::steady_clock::now() - start;
+        if (spent.count() >= budgetMs) break;
+    }
+
+    return ran;
+}
+
+size_t pendingLoads()
+{
+    return pending;
+}
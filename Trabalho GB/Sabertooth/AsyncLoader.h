@@ -0,0 +1,24 @@
+#pragma once
+#include <functional>
+#include <cstddef>
+
+// Carregamento assncrono de assets. Uma thread de trabalho faz leitura,
+// parsing e decodificao; tudo o que toca o GL volta para a thread do
+// contexto por uma fila, consumida a cada frame dentro de um oramento.
+
+// Inicia a thread de trabalho. Deve ser chamada na thread do contexto GL.
+void startAsyncLoader();
+void stopAsyncLoader();
+
+// Enfileira um job para a thread de trabalho (roda na hora se ela no existe).
+void submitLoadJob(std::function<void()> job);
+
+// Enfileira uma tarefa de GL. Na prpria thread do GL a tarefa roda na hora.
+void postGLTask(std::function<void()> task);
+
+// Roda tarefas de GL em ordem at gastar `budgetMs` (ao menos uma por
+// chamada, se houver). Devolve quantas rodaram.
+int runGLTasks(double budgetMs);
+
+// Jobs e tarefas de GL ainda no concludos.
+size_t pendingLoads();
@@ -0,0 +1,385 @@
+#include "BinaryMesh.h"
+#include "MappedFile.h"
+#include "AssetCache.h"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <map>
+#include <algorithm>
+#include <memory>
+#include <glm/gtc/type_ptr.hpp>
+
+// Layout do arquivo (little endian):
+//   SMeshHeader
+//   mtlLibCount strings   (uint32 tamanho + bytes, alinhado em 4)
+//   groupCount strings    (nome de cada grupo)
+//   SMeshGroup[groupCount]
+//   blocos de vrtices e ndices, cada um alinhado em 16 bytes
+
+static const char SMESH_MAGIC[4] = { 'S', 'M', 'S', 'H' };
+static const uint32_t SMESH_VERSION = 5;
+
+struct SMeshHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+    uint32_t groupCount;
+    uint32_t mtlLibCount;
+    uint32_t reserved[2];
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+enum SMeshGroupFlags {
+    SMESH_QUANTIZED_POSITIONS = 1,
+    SMESH_HAS_TEXCOORDS = 2,
+    SMESH_OPTIMIZED_ORDER = 4
+};
+
+struct SMeshGroup {
+    int32_t materialLib;     // .mtl (ndice em mtlLibs) do material do grupo; -1 sem material
+    uint32_t flags;          // SMeshGroupFlags
+    uint32_t vertexStride;   // bytes por vrtice (PackedVertex / PackedVertexF)
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t indexType;      // GL_UNSIGNED_SHORT ou GL_UNSIGNED_INT
+    uint64_t vertexOffset;   // a partir do incio do arquivo
+    uint64_t indexOffset;
+    float boundsMin[3];
+    float boundsMax[3];
+    float posScale[3];
+    float posBias[3];
+    uint32_t lodCount;       // nveis de detalhe (faixas do bloco de ndices)
+    uint32_t lodFirstIndex[MAX_LODS];
+    uint32_t lodIndexCount[MAX_LODS];
+    float lodError[MAX_LODS];
+};
+
+static size_t align(size_t v, size_t a) { return (v + a - 1) / a * a; }
+
+static size_t stringSize(const std::string& s) { return align(4 + s.size(), 4); }
+
+std::string binaryMeshPath(const std::string& objPath)
+{
+    size_t dot = objPath.find_last_of('.');
+    size_t slash = objPath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return objPath + ".smesh";
+    return objPath.substr(0, dot) + ".smesh";
+}
+
+uint64_t hashBytes(const void* data, size_t size)
+{
+    // FNV-1a sobre palavras de 64 bits + mistura final
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t h = 14695981039346656037ULL ^ (uint64_t)size;
+
+    const unsigned char* p = (const unsigned char*)data;
+    size_t words = size / 8;
+    for (size_t i = 0; i < words; i++) {
+        uint64_t w;
+        std::memcpy(&w, p + i * 8, 8);
+        h = (h ^ w) * prime;
+    }
+    for (size_t i = words * 8; i < size; i++)
+        h = (h ^ p[i]) * prime;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// ---------------------------------------------------------------------------
+// Escrita
+// ---------------------------------------------------------------------------
+
+static void writePadding(std::ofstream& out, size_t& pos, size_t alignment)
+{
+    static const char zeros[16] = {};
+    size_t target = align(pos, alignment);
+    out.write(zeros, target - pos);
+    pos = target;
+}
+
+static void writeString(std::ofstream& out, size_t& pos, const std::string& s)
+{
+    uint32_t len = (uint32_t)s.size();
+    out.write((const char*)&len, 4);
+    out.write(s.data(), s.size());
+    pos += 4 + s.size();
+    writePadding(out, pos, 4);
+}
+
+bool writeBinaryMesh(const std::string& objPath, const Mesh* mesh, uint64_t sourceHash, uint64_t sourceSize)
+{
+    std::string path = binaryMeshPath(objPath);
+    std::string tmpPath = path + ".tmp";
+
+    // blocos de ndices no mesmo formato que Group::uploadBuffers envia
+    std::vector<std::vector<uint16_t>> shortIndices(mesh->groups.size());
+    std::vector<SMeshGroup> records(mesh->groups.size());
+
+    size_t pos = sizeof(SMeshHeader);
+    for (const std::string& lib : mesh->mtlLibs) pos += stringSize(lib);
+    for (const Group* g : mesh->groups) pos += stringSize(g->name);
+    pos = align(pos, 8) + records.size() * sizeof(SMeshGroup);
+
+    for (size_t i = 0; i < mesh->groups.size(); i++)
+    {
+        const Group* g = mesh->groups[i];
+        SMeshGroup& r = records[i];
+        std::memset(&r, 0, sizeof(r));
+
+        r.materialLib = g->material ? g->materialLib : -1;
+        r.flags = (g->quantizedPositions ? SMESH_QUANTIZED_POSITIONS : 0) |
+                  (g->hasTexCoords ? SMESH_HAS_TEXCOORDS : 0) |
+                  (g->optimizedOrder ? SMESH_OPTIMIZED_ORDER : 0);
+        r.vertexStride = (uint32_t)g->vertexStride;
+        r.vertexCount = (uint32_t)(g->vertexData.size() / g->vertexStride);
+        r.indexCount = (uint32_t)g->indices.size();
+        r.indexType = (r.vertexCount <= 0xFFFF) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        std::memcpy(r.boundsMin, &g->boundsMin[0], sizeof(r.boundsMin));
+        std::memcpy(r.boundsMax, &g->boundsMax[0], sizeof(r.boundsMax));
+        std::memcpy(r.posScale, &g->posScale[0], sizeof(r.posScale));
+        std::memcpy(r.posBias, &g->posBias[0], sizeof(r.posBias));
+
+        r.lodCount = (uint32_t)std::min<size_t>(g->lods.size(), MAX_LODS);
+        for (uint32_t l = 0; l < r.lodCount; l++) {
+            r.lodFirstIndex[l] = g->lods[l].firstIndex;
+            r.lodIndexCount[l] = g->lods[l].indexCount;
+            r.lodError[l] = g->lods[l].error;
+        }
+
+        pos = align(pos, 16);
+        r.vertexOffset = pos;
+        pos += g->vertexData.size();
+
+        pos = align(pos, 16);
+        r.indexOffset = pos;
+        if (r.indexType == GL_UNSIGNED_SHORT) {
+            shortIndices[i].assign(g->indices.begin(), g->indices.end());
+            pos += shortIndices[i].size() * sizeof(uint16_t);
+        }
+        else {
+            pos += g->indices.size() * sizeof(uint32_t);
+        }
+    }
+
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[SMESH] AVISO: no foi possvel criar " << tmpPath << std::endl;
+        return false;
+    }
+
+    SMeshHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SMESH_MAGIC, 4);
+    header.version = SMESH_VERSION;
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    header.groupCount = (uint32_t)mesh->groups.size();
+    header.mtlLibCount = (uint32_t)mesh->mtlLibs.size();
+    std::memcpy(header.boundsMin, &mesh->boundsMin[0], sizeof(header.boundsMin));
+    std::memcpy(header.boundsMax, &mesh->boundsMax[0], sizeof(header.boundsMax));
+
+    pos = 0;
+    out.write((const char*)&header, sizeof(header));
+    pos += sizeof(header);
+
+    for (const std::string& lib : mesh->mtlLibs) writeString(out, pos, lib);
+    for (const Group* g : mesh->groups) writeString(out, pos, g->name);
+
+    writePadding(out, pos, 8);
+    out.write((const char*)records.data(), records.size() * sizeof(SMeshGroup));
+    pos += records.size() * sizeof(SMeshGroup);
+
+    for (size_t i = 0; i < mesh->groups.size(); i++)
+    {
+        const Group* g = mesh->groups[i];
+
+        writePadding(out, pos, 16);
+        out.write((const char*)g->vertexData.data(), g->vertexData.size());
+        pos += g->vertexData.size();
+
+        writePadding(out, pos, 16);
+        if (records[i].indexType == GL_UNSIGNED_SHORT) {
+            out.write((const char*)shortIndices[i].data(), shortIndices[i].size() * sizeof(uint16_t));
+            pos += shortIndices[i].size() * sizeof(uint16_t);
+        }
+        else {
+            out.write((const char*)g->indices.data(), g->indices.size() * sizeof(uint32_t));
+            pos += g->indices.size() * sizeof(uint32_t);
+        }
+    }
+
+    out.close();
+    if (!out) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    // troca atmica: quem estiver lendo nunca v um arquivo pela metade
+    std::remove(path.c_str());
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    std::cout << "[SMESH] Cache gravado: " << path << " (" << pos / 1024 << " KB)\n";
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Leitura
+// ---------------------------------------------------------------------------
+
+struct SMeshReader {
+    const char* base;
+    size_t size;
+    size_t pos = 0;
+
+    bool read(void* dst, size_t n)
+    {
+        if (pos + n > size) return false;
+        std::memcpy(dst, base + pos, n);
+        pos += n;
+        return true;
+    }
+
+    bool readString(std::string& s)
+    {
+        uint32_t len;
+        if (!read(&len, 4) || pos + len > size) return false;
+        s.assign(base + pos, len);
+        pos = align(pos + len, 4);
+        return true;
+    }
+
+    bool contains(uint64_t offset, uint64_t bytes) const
+    {
+        return offset <= size && bytes <= size - offset;
+    }
+};
+
+Mesh* loadBinaryMesh(const std::string& objPath)
+{
+    std::string path = binaryMeshPath(objPath);
+
+    // compartilhado com as tarefas de upload, que rodam depois na thread do GL
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    if (!file->open(path))
+        return nullptr;
+
+    SMeshReader r{ file->data(), file->size() };
+
+    SMeshHeader header;
+    if (!r.read(&header, sizeof(header)) ||
+        std::memcmp(header.magic, SMESH_MAGIC, 4) != 0 ||
+        header.version != SMESH_VERSION)
+    {
+        std::cout << "[SMESH] Cache em formato antigo, ignorando: " << path << "\n";
+        return nullptr;
+    }
+
+    {
+        MappedFile source;
+        if (!source.open(objPath) ||
+            source.size() != header.sourceSize ||
+            hashBytes(source.data(), source.size()) != header.sourceHash)
+        {
+            std::cout << "[SMESH] Cache desatualizado: " << path << "\n";
+            return nullptr;
+        }
+    }
+
+    Mesh* mesh = new Mesh();
+    std::vector<std::string> names(header.groupCount);
+    mesh->mtlLibs.resize(header.mtlLibCount);
+
+    bool ok = true;
+    for (auto& lib : mesh->mtlLibs) ok = ok && r.readString(lib);
+    for (auto& name : names) ok = ok && r.readString(name);
+
+    std::vector<SMeshGroup> records(header.groupCount);
+    r.pos = align(r.pos, 8);
+    ok = ok && r.read(records.data(), records.size() * sizeof(SMeshGroup));
+
+    for (const SMeshGroup& g : records)
+    {
+        size_t indexSize = (g.indexType == GL_UNSIGNED_SHORT) ? 2 : 4;
+        uint32_t stride = (g.flags & SMESH_QUANTIZED_POSITIONS) ? sizeof(PackedVertex) : sizeof(PackedVertexF);
+        ok = ok && (g.indexType == GL_UNSIGNED_SHORT || g.indexType == GL_UNSIGNED_INT)
+                && g.vertexStride == stride
+                && r.contains(g.vertexOffset, (uint64_t)g.vertexCount * g.vertexStride)
+                && r.contains(g.indexOffset, (uint64_t)g.indexCount * indexSize)
+                && g.lodCount <= MAX_LODS
+                && g.materialLib >= -1 && g.materialLib < (int32_t)header.mtlLibCount;
+        for (uint32_t l = 0; ok && l < g.lodCount; l++)
+            ok = (uint64_t)g.lodFirstIndex[l] + g.lodIndexCount[l] <= g.indexCount;
+    }
+
+    if (!ok) {
+        std::cerr << "[SMESH] AVISO: cache corrompido: " << path << std::endl;
+        delete mesh;
+        return nullptr;
+    }
+
+    // cache gravado sem a otimizao de ordem: refaz a partir do .obj
+    for (const SMeshGroup& g : records)
+    {
+        if (mesh->optimizeVertexOrder && g.indexCount > 0 && !(g.flags & SMESH_OPTIMIZED_ORDER)) {
+            std::cout << "[SMESH] Cache sem otimizao de ordem: " << path << "\n";
+            delete mesh;
+            return nullptr;
+        }
+    }
+
+    // por biblioteca: o mesmo nome pode existir em dois .mtl
+    std::vector<std::map<std::string, Material*>> materials;
+    for (const std::string& lib : mesh->mtlLibs)
+        materials.push_back(acquireMaterials(lib));
+
+    mesh->boundsMin = glm::make_vec3(header.boundsMin);
+    mesh->boundsMax = glm::make_vec3(header.boundsMax);
+
+    // traz as pginas dos blocos para a memria aqui, e no nas tarefas de
+    // upload da thread do GL
+    volatile char sink = 0;
+    for (size_t off = 0; off < file->size(); off += 4096)
+        sink = sink + file->data()[off];
+
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const SMeshGroup& rec = records[i];
+
+        Group* g = new Group();
+        g->name = names[i];
+        if (rec.materialLib >= 0) {
+            auto it = materials[rec.materialLib].find(g->name);
+            if (it != materials[rec.materialLib].end()) g->material = it->second;
+            g->materialLib = rec.materialLib;
+        }
+        g->boundsMin = glm::make_vec3(rec.boundsMin);
+        g->boundsMax = glm::make_vec3(rec.boundsMax);
+        g->posScale = glm::make_vec3(rec.posScale);
+        g->posBias = glm::make_vec3(rec.posBias);
+        g->quantizedPositions = (rec.flags & SMESH_QUANTIZED_POSITIONS) != 0;
+        g->hasTexCoords = (rec.flags & SMESH_HAS_TEXCOORDS) != 0;
+        g->optimizedOrder = (rec.flags & SMESH_OPTIMIZED_ORDER) != 0;
+        for (uint32_t l = 0; l < rec.lodCount; l++)
+            g->lods.push_back({ rec.lodFirstIndex[l], rec.lodIndexCount[l], rec.lodError[l] });
+        g->vertexStride = (int)rec.vertexStride;
+
+        // upload direto das pginas mapeadas, sem cpia intermediria
+        g->postUpload(file->data() + rec.vertexOffset, (int)rec.vertexCount,
+                      file->data() + rec.indexOffset, (int)rec.indexCount, rec.indexType, file);
+
+        mesh->groups.push_back(g);
+    }
+
+    std::cout << "[SMESH] Cache carregado: " << path << " (" << mesh->groups.size() << " grupos)\n";
+    return mesh;
+}
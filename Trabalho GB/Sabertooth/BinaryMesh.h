@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "Mesh.h"
+
+// Cache binrio de malhas (.smesh), gravado ao lado do .obj de origem.
+// Guarda os blocos de vrtices/ndices j no formato da GPU, a tabela de
+// grupos/materiais e os bounds, junto com o hash do .obj que o gerou.
+
+// Caminho do .smesh correspondente a um .obj ("car.obj" -> "car.smesh").
+std::string binaryMeshPath(const std::string& objPath);
+
+// Hash do contedo do arquivo de origem (para invalidar o cache).
+uint64_t hashBytes(const void* data, size_t size);
+
+// Grava o cache de uma malha j processada por Mesh::buildGPUData.
+bool writeBinaryMesh(const std::string& objPath, const Mesh* mesh, uint64_t sourceHash, uint64_t sourceSize);
+
+// Mapeia o .smesh e envia os blocos direto do arquivo para a GPU.
+// Devolve nullptr se o cache no existe,  de outra verso ou o .obj mudou.
+Mesh* loadBinaryMesh(const std::string& objPath);
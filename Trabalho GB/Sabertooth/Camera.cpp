@@ -22,11 +22,31 @@ Camera::Camera(glm::vec3 startPos)
     updateCameraVectors();
 }
 
-glm::mat4 Camera::getViewMatrix()
+glm::mat4 Camera::getViewMatrix() const
 {
     return glm::lookAt(position, position + front, up);
 }
 
+void Camera::getFrustumPlanes(const glm::mat4& proj, glm::vec4 planes[6]) const
+{
+    // Gribb/Hartmann: cada plano  a linha 3 da matriz somada/subtrada de
+    // uma das outras (glm guarda colunas, ento a linha i  m[0][i]..m[3][i])
+    glm::mat4 m = proj * getViewMatrix();
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; i++)
+        row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+    planes[0] = row[3] + row[0];
+    planes[1] = row[3] - row[0];
+    planes[2] = row[3] + row[1];
+    planes[3] = row[3] - row[1];
+    planes[4] = row[3] + row[2];
+    planes[5] = row[3] - row[2];
+
+    for (int i = 0; i < 6; i++)
+        planes[i] /= glm::length(glm::vec3(planes[i]));
+}
+
 void Camera::processKeyboard(int key, float deltaTime)
 {
     float velocity = speed * deltaTime;
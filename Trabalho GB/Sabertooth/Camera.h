@@ -23,7 +23,11 @@ public:
 
     Camera(glm::vec3 startPos = glm::vec3(0.0f, 1.8f, 5.0f));
 
-    glm::mat4 getViewMatrix();
+    glm::mat4 getViewMatrix() const;
+
+    // Planos do frustum de proj * view (esquerda, direita, baixo, cima,
+    // perto, longe), normalizados e com a normal para dentro.
+    void getFrustumPlanes(const glm::mat4& proj, glm::vec4 planes[6]) const;
     void processKeyboard(int key, float deltaTime);
     void processMouseMovement(float xpos, float ypos);
     void updateCameraVectors(); // deixo pblico (para compatibilidade)
@@ -0,0 +1,113 @@
+#include "Culling.h"
+#include <iostream>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CULL_SSE2 1
+#endif
+
+void BoxList::clear()
+{
+    cx.clear(); cy.clear(); cz.clear();
+    ex.clear(); ey.clear(); ez.clear();
+}
+
+void BoxList::add(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+    glm::vec3 c = (boundsMin + boundsMax) * 0.5f;
+    glm::vec3 e = (boundsMax - boundsMin) * 0.5f;
+    cx.push_back(c.x); cy.push_back(c.y); cz.push_back(c.z);
+    ex.push_back(e.x); ey.push_back(e.y); ez.push_back(e.z);
+}
+
+void transformBounds(const glm::mat4& m, const glm::vec3& localMin, const glm::vec3& localMax,
+                     glm::vec3& worldMin, glm::vec3& worldMax)
+{
+    // centro transformado; meia-extenso pelos valores absolutos da rotao/escala
+    glm::vec3 c = (localMin + localMax) * 0.5f;
+    glm::vec3 e = (localMax - localMin) * 0.5f;
+
+    glm::vec3 wc = glm::vec3(m * glm::vec4(c, 1.0f));
+    glm::vec3 we = glm::abs(glm::vec3(m[0])) * e.x + glm::abs(glm::vec3(m[1])) * e.y + glm::abs(glm::vec3(m[2])) * e.z;
+
+    worldMin = wc - we;
+    worldMax = wc + we;
+}
+
+// Fora se, para algum plano, at o canto mais "para dentro" fica atrs dele
+static bool boxVisible(const glm::vec4 planes[6], float cx, float cy, float cz, float ex, float ey, float ez)
+{
+    for (int p = 0; p < 6; p++)
+    {
+        const glm::vec4& pl = planes[p];
+        float dist = pl.x * cx + pl.y * cy + pl.z * cz + pl.w;
+        float radius = std::fabs(pl.x) * ex + std::fabs(pl.y) * ey + std::fabs(pl.z) * ez;
+        if (dist + radius < 0.0f) return false;
+    }
+    return true;
+}
+
+size_t cullBoxes(const glm::vec4 planes[6], const BoxList& boxes, std::vector<uint8_t>& visible)
+{
+    size_t n = boxes.size();
+    visible.resize(n);
+    size_t i = 0, count = 0;
+
+#ifdef CULL_SSE2
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 px[6], py[6], pz[6], pw[6], ax[6], ay[6], az[6];
+    for (int p = 0; p < 6; p++)
+    {
+        px[p] = _mm_set1_ps(planes[p].x);
+        py[p] = _mm_set1_ps(planes[p].y);
+        pz[p] = _mm_set1_ps(planes[p].z);
+        pw[p] = _mm_set1_ps(planes[p].w);
+        ax[p] = _mm_and_ps(px[p], signMask);
+        ay[p] = _mm_and_ps(py[p], signMask);
+        az[p] = _mm_and_ps(pz[p], signMask);
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(&boxes.cx[i]);
+        __m128 cy = _mm_loadu_ps(&boxes.cy[i]);
+        __m128 cz = _mm_loadu_ps(&boxes.cz[i]);
+        __m128 ex = _mm_loadu_ps(&boxes.ex[i]);
+        __m128 ey = _mm_loadu_ps(&boxes.ey[i]);
+        __m128 ez = _mm_loadu_ps(&boxes.ez[i]);
+
+        // bit por caixa: 1 enquanto nenhum plano a deixou de fora
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++)
+        {
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], cx), _mm_mul_ps(py[p], cy)),
+                                     _mm_add_ps(_mm_mul_ps(pz[p], cz), pw[p]));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)), _mm_mul_ps(az[p], ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, radius), zero));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; k++) {
+            visible[i + k] = (mask >> k) & 1;
+            count += visible[i + k];
+        }
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        visible[i] = boxVisible(planes, boxes.cx[i], boxes.cy[i], boxes.cz[i], boxes.ex[i], boxes.ey[i], boxes.ez[i]) ? 1 : 0;
+        count += visible[i];
+    }
+    return count;
+}
+
+void printCullStats(const CullStats& s)
+{
+    std::cout << "[Culling] objetos " << s.objectsVisible << "/" << s.objects << " visveis ("
+        << s.objects - s.objectsVisible << " descartados), projteis " << s.projectilesVisible << "/" << s.projectiles
+        << ", grupos " << s.groupsVisible << "/" << s.groups
+        << ", faixas estticas " << s.staticDrawsVisible << "/" << s.staticDraws << "\n";
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Culling por frustum: caixas alinhadas aos eixos (AABB) testadas em lote
+// contra os 6 planos da cmera, 4 caixas por vez com SSE2 quando
+// disponvel.
+
+// Caixas em estrutura de arrays (centro e meia-extenso), o formato que o
+// teste em SIMD l direto.
+struct BoxList {
+    std::vector<float> cx, cy, cz;
+    std::vector<float> ex, ey, ez;
+
+    void clear();
+    void add(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    size_t size() const { return cx.size(); }
+};
+
+struct CullStats {
+    size_t objects = 0;          // objetos da cena testados
+    size_t objectsVisible = 0;
+    size_t projectiles = 0;
+    size_t projectilesVisible = 0;
+    size_t groups = 0;           // grupos testados (s de objetos visveis)
+    size_t groupsVisible = 0;
+    size_t staticDraws = 0;      // faixas das pginas estticas (StaticBatch)
+    size_t staticDrawsVisible = 0;
+};
+
+// AABB de mundo de uma caixa local transformada por `m`.
+void transformBounds(const glm::mat4& m, const glm::vec3& localMin, const glm::vec3& localMax,
+                     glm::vec3& worldMin, glm::vec3& worldMax);
+
+// visible[i] = 1 se a caixa i toca o frustum (planos com normal para
+// dentro, ax + by + cz + d >= 0). Devolve o nmero de visveis.
+size_t cullBoxes(const glm::vec4 planes[6], const BoxList& boxes, std::vector<uint8_t>& visible);
+
+void printCullStats(const CullStats& s);
@@ -1,9 +0,0 @@
-#pragma once
-#include <vector>
-
-class Face {
-public:
-    std::vector<int> v;   // ndices de vrtices
-    std::vector<int> vt;  // ndices de UV
-    std::vector<int> vn;  // ndices de normais
-};
\ No newline at end of file
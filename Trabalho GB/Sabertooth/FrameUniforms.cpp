@@ -0,0 +1,92 @@
+#include "FrameUniforms.h"
+#include <algorithm>
+#include <cstring>
+
+// Layouts std140 dos blocos no core.vert/core.frag
+struct GPUFrame {
+    glm::mat4 view;
+    glm::mat4 proj;
+    glm::vec4 cameraPos;
+};
+static_assert(sizeof(GPUFrame) == 144, "GPUFrame fora do layout std140");
+
+struct GPULight {
+    glm::vec4 position;   // w = ligada
+    glm::vec4 color;
+};
+
+struct GPULights {
+    GLint count;
+    GLint globalEnabled;
+    GLint pad[2];
+    GPULight lights[MAX_LIGHTS];
+};
+static_assert(sizeof(GPULights) == 16 + MAX_LIGHTS * 32, "GPULights fora do layout std140");
+
+static GLuint frameUbo = 0;
+static GLuint lightsUbo = 0;
+
+static void createBuffers()
+{
+    if (frameUbo) return;
+
+    glGenBuffers(1, &frameUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUbo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(GPUFrame), nullptr, GL_STREAM_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BINDING, frameUbo);
+
+    // sem luzes at a primeira updateLightUniforms
+    GPULights none;
+    std::memset(&none, 0, sizeof(none));
+    glGenBuffers(1, &lightsUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, lightsUbo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(GPULights), &none, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, LIGHTS_BINDING, lightsUbo);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void updateFrameUniforms(const glm::mat4& view, const glm::mat4& proj, const glm::vec3& cameraPos)
+{
+    createBuffers();
+
+    GPUFrame f;
+    f.view = view;
+    f.proj = proj;
+    f.cameraPos = glm::vec4(cameraPos, 1.0f);
+
+    // glBufferData de novo: o driver troca o armazenamento em vez de esperar
+    // os draws do frame anterior
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUbo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(f), &f, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void updateLightUniforms(const std::vector<Light>& lights, const bool* enabled, bool globalEnabled)
+{
+    createBuffers();
+
+    GPULights l;
+    std::memset(&l, 0, sizeof(l));
+    l.count = std::min((int)lights.size(), MAX_LIGHTS);
+    l.globalEnabled = globalEnabled ? 1 : 0;
+    for (int i = 0; i < l.count; i++) {
+        l.lights[i].position = glm::vec4(lights[i].position, enabled[i] ? 1.0f : 0.0f);
+        l.lights[i].color = glm::vec4(lights[i].color, 0.0f);
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, lightsUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(l), &l);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void bindFrameUniforms(GLuint program)
+{
+    GLuint frame = glGetUniformBlockIndex(program, "Frame");
+    if (frame != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, frame, FRAME_BINDING);
+
+    GLuint lights = glGetUniformBlockIndex(program, "Lights");
+    if (lights != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, lights, LIGHTS_BINDING);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "Light.h"
+
+// Estado compartilhado por todos os programas do core.vert/core.frag, em
+// dois uniform buffers std140: Frame (cmera, reenviado uma vez por frame)
+// e Lights (luzes da cena, reenviado s quando mudam). O custo por frame no
+// depende do nmero de luzes nem de programas.
+
+#define MAX_LIGHTS 8         // igual ao core.frag
+#define FRAME_BINDING 1      // ponto de ligao do bloco Frame
+#define LIGHTS_BINDING 2     // ponto de ligao do bloco Lights
+
+// Thread do GL: cmera do frame. Cria os buffers na primeira chamada.
+void updateFrameUniforms(const glm::mat4& view, const glm::mat4& proj, const glm::vec3& cameraPos);
+
+// Thread do GL: envia as luzes (at MAX_LIGHTS) com o estado liga/desliga
+// de cada uma. S quando a cena ou os interruptores mudam.
+void updateLightUniforms(const std::vector<Light>& lights, const bool* enabled, bool globalEnabled);
+
+// Liga os blocos Frame e Lights do programa aos pontos fixos (aps o link).
+void bindFrameUniforms(GLuint program);
@@ -0,0 +1,121 @@
+#include "Group.h"
+#include "AsyncLoader.h"
+#include <cstddef>
+#include <algorithm>
+
+// maior cpia feita por uma nica tarefa de upload
+static const size_t UPLOAD_CHUNK_BYTES = 1 << 20;
+
+Group::~Group()
+{
+    if (VAO) glDeleteVertexArrays(1, &VAO);
+    if (VBO) glDeleteBuffers(1, &VBO);
+    if (EBO) glDeleteBuffers(1, &EBO);
+}
+
+GLsizei Group::lodIndexCount(int level) const
+{
+    if (lods.empty()) return numIndices;
+    return (GLsizei)lods[std::min<size_t>(level, lods.size() - 1)].indexCount;
+}
+
+const void* Group::lodIndexOffset(int level) const
+{
+    if (lods.empty()) return (void*)0;
+    size_t indexSize = (indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+    return (void*)(lods[std::min<size_t>(level, lods.size() - 1)].firstIndex * indexSize);
+}
+
+void Group::upload(const void* vertexData, int vertexCount,
+                   const void* indexData, int indexCount, GLenum type)
+{
+    numVertices = vertexCount;
+    numIndices = indexCount;
+    indexType = type;
+
+    size_t indexSize = (type == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+
+    // VAO novo: os atributos de instncia precisam ser ligados de novo
+    instanceVBO = 0;
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)vertexCount * vertexStride, vertexData, GL_STATIC_DRAW);
+
+    // o EBO fica registrado no VAO
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (size_t)indexCount * indexSize, indexData, GL_STATIC_DRAW);
+
+    size_t normalOffset;
+    glEnableVertexAttribArray(0);
+    if (quantizedPositions) {
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, vertexStride, (void*)offsetof(PackedVertex, position));
+        normalOffset = offsetof(PackedVertex, normal);
+    }
+    else {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexStride, (void*)offsetof(PackedVertexF, position));
+        normalOffset = offsetof(PackedVertexF, normal);
+    }
+
+    // normal octadrica (2 x snorm16) e UV (2 x half), logo aps a posio
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, vertexStride, (void*)normalOffset);
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, vertexStride, (void*)(normalOffset + 2 * sizeof(int16_t)));
+
+    glBindVertexArray(0);
+}
+
+void Group::postUpload(const void* vertexData, int vertexCount,
+                       const void* indexData, int indexCount, GLenum type,
+                       std::shared_ptr<const void> keepAlive)
+{
+    const char* vertices = (const char*)vertexData;
+    const char* indices = (const char*)indexData;
+    size_t vertexBytes = (size_t)vertexCount * vertexStride;
+    size_t indexBytes = (size_t)indexCount * ((type == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint));
+
+    postGLTask([this, vertexCount, indexCount, type] {
+        upload(nullptr, vertexCount, nullptr, indexCount, type);
+    });
+
+    // GL_COPY_WRITE_BUFFER no mexe no estado de nenhum VAO
+    for (size_t off = 0; off < vertexBytes; off += UPLOAD_CHUNK_BYTES)
+    {
+        size_t n = std::min(UPLOAD_CHUNK_BYTES, vertexBytes - off);
+        postGLTask([this, vertices, off, n, keepAlive] {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, off, n, vertices + off);
+        });
+    }
+
+    for (size_t off = 0; off < indexBytes; off += UPLOAD_CHUNK_BYTES)
+    {
+        size_t n = std::min(UPLOAD_CHUNK_BYTES, indexBytes - off);
+        postGLTask([this, indices, off, n, keepAlive] {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, off, n, indices + off);
+        });
+    }
+}
+
+size_t Group::uploadBuffers()
+{
+    int vertexCount = (int)(vertexData.size() / vertexStride);
+    size_t bytes = vertexData.size();
+
+    if (vertexCount <= 0xFFFF)
+    {
+        auto shortIndices = std::make_shared<std::vector<uint16_t>>(indices.begin(), indices.end());
+        postUpload(vertexData.data(), vertexCount, shortIndices->data(), (int)shortIndices->size(), GL_UNSIGNED_SHORT, shortIndices);
+        return bytes + shortIndices->size() * sizeof(uint16_t);
+    }
+
+    // vertexData/indices pertencem ao grupo e vivem at ele ser destrudo
+    postUpload(vertexData.data(), vertexCount, indices.data(), (int)indices.size(), GL_UNSIGNED_INT, nullptr);
+    return bytes + indices.size() * sizeof(uint32_t);
+}
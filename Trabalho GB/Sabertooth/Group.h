@@ -1,19 +1,94 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #include <string>
+#include <memory>
 #include <GL/glew.h>
+#include <glm/glm.hpp>
 
-#include "Face.h"
 #include "Material.h"
 
+// Vrtice intercalado e quantizado (atributos 0, 1 e 2 do core.vert).
+// Com posies quantizadas: 16 bytes; com posies em float: 20 bytes.
+struct PackedVertex {
+    int16_t position[4];   // snorm16 dentro dos bounds do grupo (w = alinhamento)
+    int16_t normal[2];     // normal octadrica, snorm16
+    uint16_t uv[2];        // half float
+};
+
+struct PackedVertexF {
+    float position[3];
+    int16_t normal[2];
+    uint16_t uv[2];
+};
+
+// Converses usadas no empacotamento (Mesh.cpp): snorm16 como o GL o l e
+// normal unitria <-> octaedro projetado em [-1, 1]^2
+int16_t toSnorm16(float v);
+float fromSnorm16(int16_t v);
+glm::vec2 octEncode(glm::vec3 n);
+glm::vec3 octDecode(glm::vec2 e);
+
+// Nvel de detalhe: uma faixa de `indices` sobre os mesmos vrtices.
+struct LodLevel {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float error;           // erro geomtrico da simplificao (unidades do modelo)
+};
+
+const int MAX_LODS = 4;
+
 class Group {
 public:
-    std::string name;    
+    ~Group();
+
+    std::string name;
     Material* material = nullptr;
+    int materialLib = -1;   // ndice em Mesh::mtlLibs de onde veio o material
 
-    std::vector<Face*> faces;
+    // (v, vt, vn) de cada canto, 3 cantos por tringulo, contguos
+    std::vector<glm::ivec3> corners;
+
+    // Dados prontos para a GPU, gerados por Mesh::buildGPUData
+    std::vector<unsigned char> vertexData;   // PackedVertex ou PackedVertexF
+    std::vector<uint32_t> indices;         // todos os nveis, concatenados
+    std::vector<LodLevel> lods;            // lods[0] = malha completa
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
+    // Formato dos vrtices; valem tambm para grupos vindos do cache binrio
+    bool quantizedPositions = false;
+    bool hasTexCoords = false;
+    bool optimizedOrder = false;   // ordem de tringulos do MeshOptimizer mantida (no pior que a do arquivo)
+    int vertexStride = sizeof(PackedVertexF);
+    glm::vec3 posScale = glm::vec3(1.0f);   // posio = aPos * posScale + posBias
+    glm::vec3 posBias = glm::vec3(0.0f);
 
     GLuint VAO = 0;
     GLuint VBO = 0;
-    int numVertices = 0;
-};
\ No newline at end of file
+    GLuint EBO = 0;
+    GLuint instanceVBO = 0;   // buffer de instncias ligado aos atributos 3..6 deste VAO
+    int numVertices = 0;   // vrtices nicos no VBO
+    int numIndices = 0;    // ndices no EBO (3 por tringulo, todos os nveis)
+    GLenum indexType = GL_UNSIGNED_INT;
+
+    // Cria VAO/VBO/EBO a partir de dados j no formato da GPU
+    // (layout dado por quantizedPositions / vertexStride).
+    void upload(const void* vertexData, int vertexCount,
+                const void* indexData, int indexCount, GLenum type);
+
+    // Faixa do EBO a desenhar no nvel `level` (limitado ao ltimo existente)
+    GLsizei lodIndexCount(int level) const;
+    const void* lodIndexOffset(int level) const;
+
+    // upload() pela fila do GL, em partes: uma tarefa cria os buffers e as
+    // seguintes copiam o contedo em blocos, para caber no oramento do
+    // frame. `keepAlive` segura a memria de origem at a ltima tarefa.
+    void postUpload(const void* vertexData, int vertexCount,
+                    const void* indexData, int indexCount, GLenum type,
+                    std::shared_ptr<const void> keepAlive);
+
+    // Posta o envio de vertexData/indices, com ndices de 16 bits quando
+    // couberem. Devolve os bytes ocupados na GPU.
+    size_t uploadBuffers();
+};
@@ -2,6 +2,7 @@
 #include <string>
 #include <glm/glm.hpp>
 #include <GL/glew.h>
+#include "TextureCache.h"
 
 
 struct Material {
@@ -9,11 +10,17 @@ struct Material {
 
     // J existiam:
     glm::vec3 kd = glm::vec3(1.0f); // cor difusa
-    unsigned int textureID = 0;
-    bool hasTexture = false;
 
     // ADICIONAR:
     glm::vec3 ka = glm::vec3(0.1f);   // ambiente
     glm::vec3 ks = glm::vec3(1.0f);   // especular
     float shininess = 32.0f;          // Ns do MTL
+
+    // map_Kd, compartilhada pelo cache de texturas; carregada na primeira
+    // vez que o material  desenhado (touchTexture)
+    Texture* texture = nullptr;
+
+    // entrada na tabela de materiais da GPU (MaterialTable), compartilhada
+    // entre materiais iguais; -1 enquanto no registrado
+    int gpuIndex = -1;
 };
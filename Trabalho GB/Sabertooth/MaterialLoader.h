@@ -3,4 +3,7 @@
 #include <map>
 #include "Material.h"
 
-std::map<std::string, Material*> loadMTL(const std::string& path);
\ No newline at end of file
+// L o .mtl (pode rodar fora da thread do contexto). As texturas s entram
+// no cache de texturas, com a cor mdia como substituta; a carga de verdade
+// acontece na primeira vez que um grupo com o material  desenhado.
+std::map<std::string, Material*> parseMTL(const std::string& path);
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "MaterialTable.h"
+#include <vector>
+#include <mutex>
+#include <map>
+#include <tuple>
+#include <iostream>
+#include <cstring>
+
+// Layout std140 de MaterialData no core.frag
+struct GPUMaterial {
+    glm::vec4 ka;
+    glm::vec4 kd;
+    glm::vec4 ks;          // w = shininess
+    glm::vec4 atlasRect;   // ou a cor mdia, com TEXTURE_PLACEHOLDER
+    GLint hasTexture;
+    GLint texPage;
+    GLint texLayer;
+    GLint pad;
+};
+static_assert(sizeof(GPUMaterial) == 80, "GPUMaterial fora do layout std140");
+
+// Chave de igualdade entre materiais
+typedef std::tuple<float, float, float, float, float, float, float, float, float, float, const Texture*> MaterialKey;
+
+// Cpia dos valores (e no ponteiro): qualquer uma das cpias iguais pode
+// ser apagada primeiro
+struct MaterialSlot {
+    Material values;
+    int refs = 0;
+    MaterialKey key;
+};
+
+static std::mutex tableMutex;
+static std::vector<MaterialSlot> slots(MAX_MATERIALS);
+static std::map<MaterialKey, int> slotByKey;
+static std::vector<int> dirtySlots;
+static GLuint ubo = 0;
+
+static MaterialKey keyOf(const Material* m)
+{
+    return MaterialKey(m->ka.r, m->ka.g, m->ka.b, m->kd.r, m->kd.g, m->kd.b,
+        m->ks.r, m->ks.g, m->ks.b, m->shininess, m->texture);
+}
+
+void registerMaterial(Material* mat)
+{
+    MaterialKey key = keyOf(mat);
+    std::lock_guard<std::mutex> lock(tableMutex);
+
+    auto it = slotByKey.find(key);
+    if (it != slotByKey.end()) {
+        slots[it->second].refs++;
+        mat->gpuIndex = it->second;
+        return;
+    }
+
+    // 0  o padro
+    for (int i = 1; i < MAX_MATERIALS; i++)
+    {
+        if (slots[i].refs > 0) continue;
+        slots[i].values = *mat;
+        slots[i].refs = 1;
+        slots[i].key = key;
+        slotByKey[key] = i;
+        dirtySlots.push_back(i);
+        mat->gpuIndex = i;
+        return;
+    }
+
+    std::cerr << "[Materiais] AVISO: tabela cheia (" << MAX_MATERIALS << "), usando o padro para "
+        << mat->name << std::endl;
+    mat->gpuIndex = 0;
+}
+
+void unregisterMaterial(Material* mat)
+{
+    std::lock_guard<std::mutex> lock(tableMutex);
+    int i = mat->gpuIndex;
+    mat->gpuIndex = -1;
+    if (i <= 0 || --slots[i].refs > 0) return;
+
+    slotByKey.erase(slots[i].key);
+    slots[i].values = Material();
+}
+
+void invalidateMaterial(const Material* mat)
+{
+    std::lock_guard<std::mutex> lock(tableMutex);
+    if (mat->gpuIndex > 0) dirtySlots.push_back(mat->gpuIndex);
+}
+
+void invalidateTextureMaterials(const Texture* tex)
+{
+    std::lock_guard<std::mutex> lock(tableMutex);
+    for (int i = 1; i < MAX_MATERIALS; i++)
+        if (slots[i].refs > 0 && slots[i].values.texture == tex)
+            dirtySlots.push_back(i);
+}
+
+static GPUMaterial pack(const Material* m)
+{
+    GPUMaterial g;
+    std::memset(&g, 0, sizeof(g));
+    g.ka = glm::vec4(m->ka, 0.0f);
+    g.kd = glm::vec4(m->kd, 0.0f);
+    g.ks = glm::vec4(m->ks, m->shininess);
+    g.atlasRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    g.texPage = TEXTURE_STANDALONE;
+
+    // a textura compartilhada vive enquanto algum material igual a usa
+    const Texture* tex = m->texture;
+    if (tex && tex->resident) {
+        g.hasTexture = 1;
+        g.texPage = tex->page;
+        g.texLayer = tex->layer;
+        g.atlasRect = tex->atlasRect;
+    }
+    else if (tex) {
+        // ainda no carregada (ou tirada pelo oramento): cor mdia no lugar
+        g.hasTexture = 1;
+        g.texPage = TEXTURE_PLACEHOLDER;
+        g.atlasRect = textureAverageColor(tex);
+    }
+    return g;
+}
+
+void updateMaterialTable()
+{
+    std::lock_guard<std::mutex> lock(tableMutex);
+
+    if (!ubo)
+    {
+        Material defaultMat;
+        defaultMat.ka = glm::vec3(0.2f);
+        defaultMat.kd = glm::vec3(0.7f);
+        defaultMat.ks = glm::vec3(0.1f);
+        defaultMat.shininess = 16.0f;
+        GPUMaterial def = pack(&defaultMat);
+
+        glGenBuffers(1, &ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        glBufferData(GL_UNIFORM_BUFFER, MAX_MATERIALS * sizeof(GPUMaterial), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(GPUMaterial), &def);
+        glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BINDING, ubo);
+    }
+
+    if (dirtySlots.empty()) return;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    for (int i : dirtySlots)
+    {
+        if (slots[i].refs == 0) continue;
+        GPUMaterial g = pack(&slots[i].values);
+        glBufferSubData(GL_UNIFORM_BUFFER, i * sizeof(GPUMaterial), sizeof(GPUMaterial), &g);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    dirtySlots.clear();
+}
+
+void bindMaterialTable(GLuint program)
+{
+    GLuint block = glGetUniformBlockIndex(program, "Materials");
+    if (block != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, block, MATERIAL_BINDING);
+}
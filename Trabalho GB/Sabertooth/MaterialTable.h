@@ -0,0 +1,38 @@
+#pragma once
+#include <GL/glew.h>
+#include "Material.h"
+
+// Tabela de materiais na GPU: um uniform buffer std140 com todos os
+// materiais carregados, lido pelo core.frag em materials[materialIndex].
+// Materiais iguais (mesmas cores, brilho e textura), mesmo vindos de .mtl
+// diferentes, ocupam uma nica entrada. O ndice 0  o material padro dos
+// grupos sem `usemtl`.
+
+#define MAX_MATERIALS 192   // igual ao core.frag; 192 * 80 bytes cabem nos 16 KB mnimos de um UBO
+#define MATERIAL_BINDING 0  // ponto de ligao do bloco Materials
+
+// Registra o material (qualquer thread) e preenche mat->gpuIndex. Sem
+// espao na tabela o material usa o padro.
+void registerMaterial(Material* mat);
+
+// Solta a entrada do material; a ltima referncia libera o ndice.
+void unregisterMaterial(Material* mat);
+
+// Marca o material para reenvio (ex.: a textura ficou residente).
+void invalidateMaterial(const Material* mat);
+
+// Marca todos os materiais que usam a textura (mudou de lugar ou saiu da GPU).
+void invalidateTextureMaterials(const Texture* tex);
+
+// Thread do GL: cria o UBO na primeira chamada e envia as entradas que
+// mudaram. Uma vez por frame, antes dos draws.
+void updateMaterialTable();
+
+// Liga o bloco Materials do programa ao MATERIAL_BINDING (aps o link).
+void bindMaterialTable(GLuint program);
+
+// ndice do material na tabela (0 para nullptr).
+inline int materialIndex(const Material* mat)
+{
+    return (mat && mat->gpuIndex > 0) ? mat->gpuIndex : 0;
+}
@@ -1,40 +1,392 @@
 #include "Mesh.h"
 #include <GL/glew.h>
+#include <iostream>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <glm/gtc/packing.hpp>
+#include "Parallel.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
 
-void Mesh::uploadToGPU() {
+// Tabela hash de endereamento aberto (v, vt, vn) -> ndice do vrtice nico.
+// Dimensionada uma vez pelo nmero de cantos do grupo, sem alocao por insero.
+class CornerTable {
+public:
+    explicit CornerTable(size_t expected)
+    {
+        size_t cap = 16;
+        while (cap < expected * 2) cap <<= 1;
+        keys.resize(cap);
+        values.assign(cap, -1);
+        mask = cap - 1;
+    }
+
+    // Devolve o ndice j registrado para a chave, ou registra `next` e devolve -1.
+    int findOrInsert(const glm::ivec3& key, int next)
+    {
+        size_t h = ((uint32_t)key.x * 73856093u) ^ ((uint32_t)key.y * 19349663u) ^ ((uint32_t)key.z * 83492791u);
+        for (size_t i = h & mask;; i = (i + 1) & mask)
+        {
+            if (values[i] < 0) {
+                keys[i] = key;
+                values[i] = next;
+                return -1;
+            }
+            if (keys[i] == key)
+                return values[i];
+        }
+    }
+
+private:
+    std::vector<glm::ivec3> keys;
+    std::vector<int> values;
+    size_t mask;
+};
+
+int16_t toSnorm16(float v)
+{
+    return (int16_t)std::lround(glm::clamp(v, -1.0f, 1.0f) * 32767.0f);
+}
+
+float fromSnorm16(int16_t v)
+{
+    return std::max(v / 32767.0f, -1.0f);
+}
+
+glm::vec2 octEncode(glm::vec3 n)
+{
+    float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (l1 <= 0.0f) return glm::vec2(0.0f);   // normal degenerada -> +Z
+
+    n /= l1;
+    glm::vec2 e(n.x, n.y);
+    if (n.z < 0.0f) {
+        e = glm::vec2((1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                      (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    return e;
+}
+
+glm::vec3 octDecode(glm::vec2 e)
+{
+    glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    if (n.z < 0.0f) {
+        n.x = (1.0f - std::abs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f);
+        n.y = (1.0f - std::abs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return glm::normalize(n);
+}
+
+// Normais suavizadas por posio (soma das normais de face ponderadas pela
+// rea), para os cantos sem `vn`. Normais de face em paralelo; depois uma
+// tabela posio -> tringulos (CSR) permite somar por vrtice em paralelo
+// sem escrita concorrente.
+static std::vector<glm::vec3> generateNormals(const Mesh& mesh)
+{
+    std::vector<size_t> triBase(mesh.groups.size() + 1, 0);
+    for (size_t g = 0; g < mesh.groups.size(); g++)
+        triBase[g + 1] = triBase[g] + mesh.groups[g]->corners.size() / 3;
+    size_t numTris = triBase.back();
+
+    std::vector<glm::vec3> faceNormals(numTris);
+    for (size_t g = 0; g < mesh.groups.size(); g++)
+    {
+        const std::vector<glm::ivec3>& c = mesh.groups[g]->corners;
+        parallelFor(c.size() / 3, 16384, [&](size_t b, size_t e) {
+            for (size_t t = b; t < e; t++) {
+                const glm::vec3& p0 = mesh.vertices[c[t * 3 + 0].x];
+                const glm::vec3& p1 = mesh.vertices[c[t * 3 + 1].x];
+                const glm::vec3& p2 = mesh.vertices[c[t * 3 + 2].x];
+                faceNormals[triBase[g] + t] = glm::cross(p1 - p0, p2 - p0);
+            }
+        });
+    }
+
+    size_t numVerts = mesh.vertices.size();
+    std::vector<uint32_t> offsets(numVerts + 1, 0);
+    for (const Group* g : mesh.groups)
+        for (const glm::ivec3& k : g->corners) offsets[k.x + 1]++;
+    for (size_t v = 0; v < numVerts; v++)
+        offsets[v + 1] += offsets[v];
+
+    std::vector<uint32_t> adjacency(offsets.back());
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t g = 0; g < mesh.groups.size(); g++)
+    {
+        const std::vector<glm::ivec3>& c = mesh.groups[g]->corners;
+        for (size_t i = 0; i < c.size(); i++)
+            adjacency[cursor[c[i].x]++] = (uint32_t)(triBase[g] + i / 3);
+    }
+
+    std::vector<glm::vec3> normals(numVerts);
+    parallelFor(numVerts, 16384, [&](size_t b, size_t e) {
+        for (size_t v = b; v < e; v++) {
+            glm::vec3 n(0.0f);
+            for (uint32_t a = offsets[v]; a < offsets[v + 1]; a++)
+                n += faceNormals[adjacency[a]];
+            float len = glm::length(n);
+            normals[v] = (len > 0.0f) ? n / len : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    });
+
+    return normals;
+}
+
+// Nveis de detalhe do grupo, cada um simplificado a partir do anterior e
+// anexado ao fim de g->indices. O erro de cada nvel soma o dos anteriores.
+void Mesh::buildLods(Group* g, const std::vector<glm::ivec3>& unique)
+{
+    g->lods.clear();
+    g->lods.push_back({ 0, (uint32_t)g->indices.size(), 0.0f });
+
+    int levels = std::min(lodLevels, MAX_LODS);
+    if (levels <= 1 || g->indices.empty()) return;
+
+    std::vector<glm::vec3> positions(unique.size());
+    for (size_t i = 0; i < unique.size(); i++)
+        positions[i] = vertices[unique[i].x];
+
+    std::vector<uint32_t> level(g->indices);
+    for (int l = 1; l < levels; l++)
+    {
+        float error = 0.0f;
+        std::vector<uint32_t> next = simplifyMesh(level, positions, level.size() / 6 * 3, &error);
+
+        // quase nada colapsou (bordas/costuras travadas): para a cadeia aqui
+        if (next.empty() || next.size() * 10 > level.size() * 9)
+            break;
+
+        if (optimizeVertexOrder)
+            optimizeTriangleOrder(next, positions, VERTEX_CACHE_SIZE);
+
+        g->lods.push_back({ (uint32_t)g->indices.size(), (uint32_t)next.size(), g->lods.back().error + error });
+        g->indices.insert(g->indices.end(), next.begin(), next.end());
+        level.swap(next);
+    }
+
+    std::cout << "[LOD] " << g->name << ":";
+    for (const LodLevel& lod : g->lods)
+        std::cout << " " << lod.indexCount / 3;
+    std::cout << " tringulos\n";
+}
+
+int Mesh::lodCount() const
+{
+    size_t n = 1;
+    for (const Group* g : groups)
+        n = std::max(n, g->lods.size());
+    return (int)n;
+}
+
+float Mesh::lodError(int level) const
+{
+    float error = 0.0f;
+    for (const Group* g : groups)
+        if (!g->lods.empty())
+            error = std::max(error, g->lods[std::min<size_t>(level, g->lods.size() - 1)].error);
+    return error;
+}
+
+void Mesh::buildGPUData()
+{
+    bool missingNormals = false;
+    for (const Group* g : groups)
+        for (const glm::ivec3& k : g->corners)
+            if (k.z < 0 || k.z >= (int)normals.size()) { missingNormals = true; break; }
+
+    std::vector<glm::vec3> generated;
+    if (missingNormals)
+        generated = generateNormals(*this);
+
+    bool first = true;
+
+    size_t soupBytes = 0, indexedBytes = 0;
+    size_t soupInvocations = 0, fileOrderInvocations = 0, indexedInvocations = 0;
+    size_t optimizedGroups = 0;
 
     for (Group* g : groups)
     {
-        std::vector<float> bufferPositions;
-        bufferPositions.reserve(g->faces.size() * 9); 
+        std::vector<glm::ivec3> unique;
+        g->indices.clear();
+        g->indices.reserve(g->corners.size());
+
+        CornerTable table(g->corners.size());
 
-        for (Face* f : g->faces)
+        for (const glm::ivec3& key : g->corners)
         {
-            for (int idx : f->v)
-            {
-                glm::vec3 p = vertices[idx];
-                bufferPositions.push_back(p.x);
-                bufferPositions.push_back(p.y);
-                bufferPositions.push_back(p.z);
+            int next = (int)unique.size();
+            int found = table.findOrInsert(key, next);
+
+            if (found >= 0) {
+                g->indices.push_back((uint32_t)found);
+                continue;
             }
+
+            unique.push_back(key);
+            g->indices.push_back((uint32_t)next);
         }
 
-        g->numVertices = bufferPositions.size() / 3;
+        size_t fileOrderMisses = countCacheMisses(g->indices, VERTEX_CACHE_SIZE);
+        fileOrderInvocations += fileOrderMisses;
 
-       
-        glGenVertexArrays(1, &g->VAO);
-        glBindVertexArray(g->VAO);
+        g->optimizedOrder = false;
+        if (optimizeVertexOrder && !g->indices.empty())
+        {
+            std::vector<glm::vec3> positions(unique.size());
+            for (size_t i = 0; i < unique.size(); i++)
+                positions[i] = vertices[unique[i].x];
+
+            // malhas j bem ordenadas no arquivo mantm a ordem original
+            std::vector<uint32_t> original = g->indices;
+            optimizeTriangleOrder(g->indices, positions, VERTEX_CACHE_SIZE);
+            g->optimizedOrder = countCacheMisses(g->indices, VERTEX_CACHE_SIZE) <= fileOrderMisses;
+            if (g->optimizedOrder) optimizedGroups++;
+            else g->indices.swap(original);
+
+            // a renumerao dos vrtices no muda o ACMR: vale nas duas ordens
+            std::vector<uint32_t> remap = optimizeVertexFetch(g->indices, unique.size());
+            std::vector<glm::ivec3> reordered(unique.size());
+            for (size_t i = 0; i < unique.size(); i++)
+                reordered[remap[i]] = unique[i];
+            unique.swap(reordered);
+        }
+
+        glm::vec3 gMin(0.0f), gMax(0.0f);
+        g->hasTexCoords = false;
+        for (size_t i = 0; i < unique.size(); i++)
+        {
+            const glm::vec3& p = vertices[unique[i].x];
+            gMin = (i == 0) ? p : glm::min(gMin, p);
+            gMax = (i == 0) ? p : glm::max(gMax, p);
+            if (unique[i].y >= 0 && unique[i].y < (int)texcoords.size()) g->hasTexCoords = true;
+        }
+
+        g->boundsMin = gMin;
+        g->boundsMax = gMax;
 
-        
-        glGenBuffers(1, &g->VBO);
-        glBindBuffer(GL_ARRAY_BUFFER, g->VBO);
-        glBufferData(GL_ARRAY_BUFFER, bufferPositions.size() * sizeof(float), bufferPositions.data(), GL_STATIC_DRAW);
+        if (!g->indices.empty()) {
+            boundsMin = first ? gMin : glm::min(boundsMin, gMin);
+            boundsMax = first ? gMax : glm::max(boundsMax, gMax);
+            first = false;
+        }
 
-        
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        g->quantizedPositions = quantizePositions;
+        if (g->quantizedPositions) {
+            g->vertexStride = sizeof(PackedVertex);
+            g->posBias = (gMin + gMax) * 0.5f;
+            g->posScale = glm::max((gMax - gMin) * 0.5f, glm::vec3(1e-6f));
+        }
+        else {
+            g->vertexStride = sizeof(PackedVertexF);
+            g->posBias = glm::vec3(0.0f);
+            g->posScale = glm::vec3(1.0f);
+        }
 
-        
-        glBindVertexArray(0);
+        g->vertexData.assign(unique.size() * g->vertexStride, 0);
+
+        parallelFor(unique.size(), 16384, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; i++)
+            {
+                const glm::ivec3& k = unique[i];
+                glm::vec3 p = vertices[k.x];
+                glm::vec3 n = (k.z >= 0 && k.z < (int)normals.size()) ? normals[k.z] : generated[k.x];
+                glm::vec2 t = (k.y >= 0 && k.y < (int)texcoords.size()) ? texcoords[k.y] : glm::vec2(0.0f);
+
+                glm::vec2 oct = octEncode(n);
+                int16_t packedNormal[2] = { toSnorm16(oct.x), toSnorm16(oct.y) };
+                uint16_t packedUV[2] = { glm::packHalf1x16(t.x), glm::packHalf1x16(t.y) };
+
+                unsigned char* dst = &g->vertexData[i * g->vertexStride];
+                if (g->quantizedPositions) {
+                    PackedVertex* v = (PackedVertex*)dst;
+                    glm::vec3 q = (p - g->posBias) / g->posScale;
+                    v->position[0] = toSnorm16(q.x);
+                    v->position[1] = toSnorm16(q.y);
+                    v->position[2] = toSnorm16(q.z);
+                    v->position[3] = 0;
+                    std::memcpy(v->normal, packedNormal, sizeof(packedNormal));
+                    std::memcpy(v->uv, packedUV, sizeof(packedUV));
+                }
+                else {
+                    PackedVertexF* v = (PackedVertexF*)dst;
+                    v->position[0] = p.x;
+                    v->position[1] = p.y;
+                    v->position[2] = p.z;
+                    std::memcpy(v->normal, packedNormal, sizeof(packedNormal));
+                    std::memcpy(v->uv, packedUV, sizeof(packedUV));
+                }
+            }
+        });
+
+        // os cantos j viraram vrtices + ndices
+        std::vector<glm::ivec3>().swap(g->corners);
+
+        size_t indexSize = (unique.size() <= 0xFFFF) ? sizeof(uint16_t) : sizeof(uint32_t);
+        soupBytes += g->indices.size() * 8 * sizeof(float);   // posio + normal + UV em float
+        indexedBytes += g->vertexData.size() + g->indices.size() * indexSize;
+        soupInvocations += g->indices.size();
+        indexedInvocations += countCacheMisses(g->indices, VERTEX_CACHE_SIZE);
+
+        buildLods(g, unique);
+    }
+
+    // estatsticas calculadas aqui (fora da thread do GL), no no upload
+    std::cout << "[GPU] VRAM de geometria: " << soupBytes / 1024 << " KB (sem ndices, float) -> "
+        << indexedBytes / 1024 << " KB (indexado, quantizado)\n";
+    std::cout << "[GPU] Execues do vertex shader (cache FIFO de " << VERTEX_CACHE_SIZE << "): "
+        << soupInvocations << " -> " << indexedInvocations << "\n";
+
+    size_t triangles = soupInvocations / 3;
+    if (triangles > 0) {
+        std::cout << "[GPU] ACMR: " << (float)fileOrderInvocations / triangles << " (ordem do arquivo) -> "
+            << (float)indexedInvocations / triangles;
+        if (!optimizeVertexOrder) std::cout << " (sem otimizao)\n";
+        else std::cout << " (ordem otimizada em " << optimizedGroups << " de " << groups.size() << " grupos)\n";
     }
-}
\ No newline at end of file
+}
+
+Mesh::~Mesh()
+{
+    for (Group* g : groups) delete g;
+    if (instanceVBO) glDeleteBuffers(1, &instanceVBO);
+}
+
+void Mesh::setInstances(const glm::mat4* models, int count)
+{
+    if (count <= 0) return;
+    if (instanceVBO == 0) glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    if (count > instanceCapacity)
+    {
+        instanceCapacity = std::max(count, instanceCapacity * 2);
+        glBufferData(GL_ARRAY_BUFFER, (size_t)instanceCapacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+    }
+
+    // o buffer fica registrado no VAO; s grupos com VAO novo (LOD, .smesh,
+    // upload assncrono) ainda no o tm
+    bool bound = false;
+    for (Group* g : groups)
+    {
+        if (!g->VAO || g->instanceVBO == instanceVBO) continue;
+        glBindVertexArray(g->VAO);
+        // uma mat4 ocupa 4 atributos vec4 consecutivos
+        for (int c = 0; c < 4; c++) {
+            glEnableVertexAttribArray(3 + c);
+            glVertexAttribPointer(3 + c, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(c * sizeof(glm::vec4)));
+            glVertexAttribDivisor(3 + c, 1);
+        }
+        g->instanceVBO = instanceVBO;
+        bound = true;
+    }
+    if (bound) glBindVertexArray(0);
+
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (size_t)count * sizeof(glm::mat4), models);
+}
+
+void Mesh::uploadToGPU() {
+
+    for (Group* g : groups)
+        g->uploadBuffers();
+}
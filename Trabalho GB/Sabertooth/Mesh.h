@@ -1,15 +1,56 @@
 #pragma once
 #include <vector>
+#include <string>
 #include <glm/glm.hpp>
 #include "Group.h"
 
 class Mesh {
 public:
+    Mesh() = default;
+    ~Mesh();
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
     std::vector<glm::vec3> vertices;
     std::vector<glm::vec3> normals;
     std::vector<glm::vec2> texcoords;
 
     std::vector<Group*> groups;
 
+    std::vector<std::string> mtlLibs;   // .mtl referenciados (usado pelo cache binrio)
+
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
+    // Posies em 16 bits normalizadas nos bounds de cada grupo (seno float)
+    bool quantizePositions = true;
+
+    // Reordena tringulos e vrtices de cada grupo para o cache de vrtices,
+    // overdraw e leitura sequencial do VBO (MeshOptimizer)
+    bool optimizeVertexOrder = true;
+
+    // Nveis de detalhe por grupo (1 = s a malha original, at MAX_LODS),
+    // cada um com ~metade dos tringulos do anterior (MeshSimplifier)
+    int lodLevels = MAX_LODS;
+
+    // Nmero de nveis do grupo mais detalhado e o maior erro entre os
+    // grupos no nvel `level`; usados na escolha por tamanho na tela
+    int lodCount() const;
+    float lodError(int level) const;
+
+    // Deduplica os cantos de cada grupo e gera Group::vertexData (PackedVertex,
+    // com normais geradas quando o OBJ no traz `vn`) e Group::indices.
+    void buildGPUData();
+    // Posta na fila do GL a criao dos buffers de cada grupo
     void uploadToGPU();
-};
\ No newline at end of file
+
+    // Matrizes model das instncias (atributos 3..6, divisor 1), num VBO
+    // compartilhado por todos os VAOs dos grupos. Cresce sob demanda.
+    GLuint instanceVBO = 0;
+    int instanceCapacity = 0;
+    void setInstances(const glm::mat4* models, int count);
+
+private:
+    void buildLods(Group* g, const std::vector<glm::ivec3>& unique);
+};
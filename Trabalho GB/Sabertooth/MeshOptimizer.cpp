@@ -0,0 +1,193 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+
+// clusters com menos tringulos que isso so unidos ao seguinte antes da
+// ordenao por overdraw (clusters pequenos demais estragam o cache)
+static const size_t MIN_CLUSTER_TRIANGLES = 64;
+
+size_t countCacheMisses(const std::vector<uint32_t>& indices, size_t cacheSize)
+{
+    std::vector<uint32_t> fifo(cacheSize, UINT32_MAX);
+    size_t head = 0, misses = 0;
+
+    for (uint32_t idx : indices)
+    {
+        bool hit = false;
+        for (uint32_t c : fifo)
+            if (c == idx) { hit = true; break; }
+
+        if (!hit) {
+            fifo[head] = idx;
+            head = (head + 1) % cacheSize;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+void optimizeTriangleOrder(std::vector<uint32_t>& indices,
+                           const std::vector<glm::vec3>& positions, size_t cacheSize)
+{
+    size_t numTris = indices.size() / 3;
+    size_t numVerts = positions.size();
+    if (numTris == 0) return;
+
+    // vrtice -> tringulos (CSR)
+    std::vector<uint32_t> offsets(numVerts + 1, 0);
+    for (uint32_t v : indices) offsets[v + 1]++;
+    for (size_t v = 0; v < numVerts; v++) offsets[v + 1] += offsets[v];
+
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++)
+        adjacency[cursor[indices[i]]++] = (uint32_t)(i / 3);
+
+    // tringulos ainda no emitidos por vrtice
+    std::vector<uint32_t> live(numVerts);
+    for (size_t v = 0; v < numVerts; v++) live[v] = offsets[v + 1] - offsets[v];
+
+    std::vector<size_t> cacheTime(numVerts, 0);
+    std::vector<char> emitted(numTris, 0);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+
+    std::vector<uint32_t> order;          // tringulos na nova ordem
+    std::vector<size_t> clusterStart;     // incio de cada cluster em `order`
+    order.reserve(numTris);
+
+    size_t time = cacheSize + 1;
+    size_t scan = 0;
+    int64_t fan = 0;
+    bool newCluster = true;
+
+    while (fan >= 0)
+    {
+        if (newCluster) {
+            clusterStart.push_back(order.size());
+            newCluster = false;
+        }
+
+        // emite todos os tringulos vivos em volta do vrtice atual
+        candidates.clear();
+        for (uint32_t a = offsets[fan]; a < offsets[fan + 1]; a++)
+        {
+            uint32_t t = adjacency[a];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+            order.push_back(t);
+
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = indices[t * 3 + k];
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = time;
+                    time++;
+                }
+            }
+        }
+
+        // prximo leque: o candidato que ainda estar no cache depois de
+        // emitir seus tringulos, o mais antigo possvel
+        int64_t best = -1;
+        size_t bestPriority = 0;
+        for (uint32_t v : candidates)
+        {
+            if (live[v] == 0) continue;
+            size_t priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize)
+                priority = time - cacheTime[v];
+            if (best < 0 || priority > bestPriority) {
+                best = v;
+                bestPriority = priority;
+            }
+        }
+
+        if (best < 0)
+        {
+            // beco sem sada: volta por vrtices recentes e, em ltimo caso,
+            // procura sequencialmente; o salto abre um cluster novo
+            while (!deadEnd.empty()) {
+                uint32_t d = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[d] > 0) { best = d; break; }
+            }
+            while (best < 0 && scan < numVerts) {
+                if (live[scan] > 0) best = (int64_t)scan;
+                scan++;
+            }
+            newCluster = true;
+        }
+
+        fan = best;
+    }
+
+    clusterStart.push_back(order.size());
+
+    // une clusters pequenos
+    std::vector<size_t> bounds;
+    bounds.push_back(0);
+    for (size_t c = 1; c + 1 < clusterStart.size(); c++)
+        if (clusterStart[c] - bounds.back() >= MIN_CLUSTER_TRIANGLES)
+            bounds.push_back(clusterStart[c]);
+    bounds.push_back(order.size());
+
+    // overdraw: clusters voltados para fora da malha primeiro
+    // (chave = dot(centroide do cluster - centroide da malha, normal do cluster))
+    glm::vec3 meshCenter(0.0f);
+    for (uint32_t v : indices) meshCenter += positions[v];
+    meshCenter /= (float)indices.size();
+
+    struct Cluster { size_t begin, end; float key; };
+    std::vector<Cluster> clusters;
+    for (size_t c = 0; c + 1 < bounds.size(); c++)
+    {
+        glm::vec3 center(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (size_t i = bounds[c]; i < bounds[c + 1]; i++)
+        {
+            uint32_t t = order[i];
+            const glm::vec3& p0 = positions[indices[t * 3 + 0]];
+            const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+            const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);   // |n| = 2 * rea
+            float a = glm::length(n);
+            center += (p0 + p1 + p2) * (a / 3.0f);
+            normal += n;
+            area += a;
+        }
+        if (area > 0.0f) center /= area;
+        clusters.push_back({ bounds[c], bounds[c + 1], glm::dot(center - meshCenter, normal) });
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(),
+        [](const Cluster& a, const Cluster& b) { return a.key > b.key; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (const Cluster& c : clusters)
+        for (size_t i = c.begin; i < c.end; i++)
+            for (int k = 0; k < 3; k++)
+                result.push_back(indices[order[i] * 3 + k]);
+
+    indices.swap(result);
+}
+
+std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    uint32_t next = 0;
+
+    for (uint32_t& idx : indices)
+    {
+        if (remap[idx] == UINT32_MAX) remap[idx] = next++;
+        idx = remap[idx];
+    }
+
+    // vrtices que nenhum tringulo usa vo para o fim
+    for (uint32_t& r : remap)
+        if (r == UINT32_MAX) r = next++;
+
+    return remap;
+}
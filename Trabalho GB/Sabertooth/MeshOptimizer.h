@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Otimizaes de ordem para listas de tringulos indexadas, aplicadas por
+// grupo depois da deduplicao (Mesh::buildGPUData).
+
+// Tamanho do cache ps-transformao simulado (FIFO), usado na otimizao
+// e nas medies.
+const size_t VERTEX_CACHE_SIZE = 32;
+
+// Quantas vezes o vertex shader rodaria com um cache FIFO de cacheSize.
+// Dividido pelo nmero de tringulos d o ACMR (3.0  o pior caso); o
+// Mesh::buildGPUData soma os de todos os grupos antes de dividir.
+size_t countCacheMisses(const std::vector<uint32_t>& indices, size_t cacheSize);
+
+// Reordena os tringulos para localidade no cache de vrtices (Tipsify,
+// Sander et al. 2007) e depois ordena os clusters resultantes de fora para
+// dentro, para reduzir overdraw independente do ponto de vista.
+void optimizeTriangleOrder(std::vector<uint32_t>& indices,
+                           const std::vector<glm::vec3>& positions, size_t cacheSize);
+
+// Renumera os vrtices na ordem de primeiro uso pelos ndices (acesso
+// sequencial ao VBO). Reescreve `indices` e devolve remap[antigo] = novo.
+std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount);
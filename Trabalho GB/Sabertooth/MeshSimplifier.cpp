@@ -0,0 +1,193 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <unordered_map>
+#include <cmath>
+
+// Matriz 4x4 simtrica (10 termos) da soma dos quadrados das distncias
+// aos planos dos tringulos.
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0;
+    double b2 = 0, bc = 0, bd = 0;
+    double c2 = 0, cd = 0;
+    double d2 = 0;
+
+    void addPlane(const glm::dvec3& n, double d)
+    {
+        a2 += n.x * n.x; ab += n.x * n.y; ac += n.x * n.z; ad += n.x * d;
+        b2 += n.y * n.y; bc += n.y * n.z; bd += n.y * d;
+        c2 += n.z * n.z; cd += n.z * d;
+        d2 += d * d;
+    }
+
+    void add(const Quadric& q)
+    {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+    }
+
+    double evaluate(const glm::vec3& p) const
+    {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                 + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                 + c2 * z * z + 2 * cd * z
+                 + d2;
+        return e > 0 ? e : 0;
+    }
+};
+
+struct Collapse {
+    uint32_t from, to;
+    double cost;
+};
+
+static uint64_t edgeKey(uint32_t a, uint32_t b)
+{
+    if (a > b) std::swap(a, b);
+    return ((uint64_t)a << 32) | b;
+}
+
+std::vector<uint32_t> simplifyMesh(const std::vector<uint32_t>& indices,
+                                   const std::vector<glm::vec3>& positions,
+                                   size_t targetIndexCount, float* resultError)
+{
+    size_t numVerts = positions.size();
+    std::vector<uint32_t> current = indices;
+    double maxCost = 0.0;
+
+    // vrtices fixos: costuras (posio repetida) e bordas (aresta com um s tringulo)
+    std::vector<char> locked(numVerts, 0);
+    {
+        std::vector<uint32_t> byPosition(numVerts);
+        for (uint32_t v = 0; v < numVerts; v++) byPosition[v] = v;
+        auto less = [&](uint32_t x, uint32_t y) {
+            const glm::vec3& p = positions[x];
+            const glm::vec3& q = positions[y];
+            if (p.x != q.x) return p.x < q.x;
+            if (p.y != q.y) return p.y < q.y;
+            return p.z < q.z;
+        };
+        std::sort(byPosition.begin(), byPosition.end(), less);
+        for (size_t i = 1; i < numVerts; i++)
+            if (positions[byPosition[i]] == positions[byPosition[i - 1]])
+                locked[byPosition[i]] = locked[byPosition[i - 1]] = 1;
+
+        std::unordered_map<uint64_t, uint32_t> edgeUse;
+        edgeUse.reserve(current.size());
+        for (size_t t = 0; t + 2 < current.size(); t += 3)
+            for (int k = 0; k < 3; k++)
+                edgeUse[edgeKey(current[t + k], current[t + (k + 1) % 3])]++;
+        for (const auto& e : edgeUse)
+            if (e.second == 1) locked[e.first >> 32] = locked[e.first & 0xFFFFFFFFu] = 1;
+    }
+
+    std::vector<Quadric> quadrics(numVerts);
+    for (size_t t = 0; t + 2 < current.size(); t += 3)
+    {
+        glm::dvec3 p0 = positions[current[t]], p1 = positions[current[t + 1]], p2 = positions[current[t + 2]];
+        glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+        double len = glm::length(n);
+        if (len <= 0.0) continue;
+        n /= len;
+        double d = -glm::dot(n, p0);
+        for (int k = 0; k < 3; k++) quadrics[current[t + k]].addPlane(n, d);
+    }
+
+    std::vector<uint32_t> offsets(numVerts + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> remap(numVerts);
+    std::vector<char> touched(numVerts);
+    std::vector<Collapse> candidates;
+
+    while (current.size() > targetIndexCount)
+    {
+        size_t numTris = current.size() / 3;
+
+        // vrtice -> tringulos do nvel atual
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (uint32_t v : current) offsets[v + 1]++;
+        for (size_t v = 0; v < numVerts; v++) offsets[v + 1] += offsets[v];
+        adjacency.resize(current.size());
+        {
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < current.size(); i++)
+                adjacency[cursor[current[i]]++] = (uint32_t)(i / 3);
+        }
+
+        candidates.clear();
+        for (size_t t = 0; t < numTris; t++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                uint32_t a = current[t * 3 + k], b = current[t * 3 + (k + 1) % 3];
+                Quadric q = quadrics[a];
+                q.add(quadrics[b]);
+                if (!locked[a]) candidates.push_back({ a, b, q.evaluate(positions[b]) });
+                if (!locked[b]) candidates.push_back({ b, a, q.evaluate(positions[a]) });
+            }
+        }
+        if (candidates.empty()) break;
+
+        std::sort(candidates.begin(), candidates.end(),
+            [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        // cada colapso remove ~2 tringulos; num passo s colapsos independentes
+        size_t wanted = (current.size() - targetIndexCount) / 6 + 1;
+        size_t done = 0;
+
+        for (uint32_t v = 0; v < numVerts; v++) remap[v] = v;
+        std::fill(touched.begin(), touched.end(), 0);
+
+        for (const Collapse& c : candidates)
+        {
+            if (done >= wanted) break;
+            if (touched[c.from] || touched[c.to]) continue;
+
+            // rejeita colapsos que viram algum tringulo ao contrrio
+            bool flips = false;
+            for (uint32_t a = offsets[c.from]; a < offsets[c.from + 1] && !flips; a++)
+            {
+                const uint32_t* tri = &current[adjacency[a] * 3];
+                if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) continue;
+
+                glm::vec3 p[3], q[3];
+                for (int k = 0; k < 3; k++) {
+                    p[k] = positions[tri[k]];
+                    q[k] = positions[tri[k] == c.from ? c.to : tri[k]];
+                }
+                glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+                if (glm::dot(before, after) <= 0.0f) flips = true;
+            }
+            if (flips) continue;
+
+            remap[c.from] = c.to;
+            quadrics[c.to].add(quadrics[c.from]);
+            maxCost = std::max(maxCost, c.cost);
+
+            // os tringulos em volta ficam fora dos prximos colapsos do passo
+            for (uint32_t a = offsets[c.from]; a < offsets[c.from + 1]; a++)
+                for (int k = 0; k < 3; k++) touched[current[adjacency[a] * 3 + k]] = 1;
+            touched[c.to] = 1;
+            done++;
+        }
+
+        if (done == 0) break;
+
+        size_t out = 0;
+        for (size_t t = 0; t < numTris; t++)
+        {
+            uint32_t a = remap[current[t * 3]], b = remap[current[t * 3 + 1]], c = remap[current[t * 3 + 2]];
+            if (a == b || b == c || a == c) continue;
+            current[out++] = a;
+            current[out++] = b;
+            current[out++] = c;
+        }
+        current.resize(out);
+    }
+
+    if (resultError) *resultError = (float)std::sqrt(maxCost);
+    return current;
+}
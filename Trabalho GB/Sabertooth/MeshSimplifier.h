@@ -0,0 +1,18 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Simplificao por colapso de arestas com mtrica qudrica (Garland e
+// Heckbert 1997). Um vrtice s colapsa sobre outro j existente, ento os
+// nveis de detalhe reaproveitam o VBO do nvel 0 e s mudam os ndices.
+// Vrtices de borda e de costura (mesma posio com outros atributos) ficam
+// fixos, o que preserva as fronteiras entre materiais e as costuras de UV.
+
+// Reduz `indices` at no mximo targetIndexCount ndices, ou at onde der
+// sem virar tringulos. `resultError` recebe o erro geomtrico alcanado
+// (distncia, nas unidades de `positions`).
+std::vector<uint32_t> simplifyMesh(const std::vector<uint32_t>& indices,
+                                   const std::vector<glm::vec3>& positions,
+                                   size_t targetIndexCount, float* resultError);
@@ -0,0 +1,21 @@
+#include "Obj3D.h"
+#include "Culling.h"
+
+bool Obj3D::updateWorldBounds()
+{
+    if (!mesh) return false;
+    if (mesh == boundsMesh && transform == boundsTransform) return true;
+
+    transformBounds(transform, mesh->boundsMin, mesh->boundsMax, worldMin, worldMax);
+
+    groupWorldMin.resize(mesh->groups.size());
+    groupWorldMax.resize(mesh->groups.size());
+    for (size_t i = 0; i < mesh->groups.size(); i++) {
+        const Group* g = mesh->groups[i];
+        transformBounds(transform, g->boundsMin, g->boundsMax, groupWorldMin[i], groupWorldMax[i]);
+    }
+
+    boundsMesh = mesh;
+    boundsTransform = transform;
+    return true;
+}
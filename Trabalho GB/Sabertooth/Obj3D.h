@@ -1,4 +1,5 @@
 #pragma once
+#include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Mesh.h"
@@ -8,7 +9,29 @@ public:
     Mesh* mesh = nullptr;
     glm::mat4 transform;
 
+    // Transform fixo depois da carga da cena: a geometria pode ir para as
+    // pginas estticas (StaticBatch). `staticBatched` marca quem j foi;
+    // esses objetos no so mais desenhados pelo caminho normal.
+    bool isStatic = false;
+    bool staticBatched = false;
+
+    // AABB de mundo do objeto e de cada grupo (mesma ordem de mesh->groups),
+    // vlidos depois de updateWorldBounds
+    glm::vec3 worldMin = glm::vec3(0.0f);
+    glm::vec3 worldMax = glm::vec3(0.0f);
+    std::vector<glm::vec3> groupWorldMin;
+    std::vector<glm::vec3> groupWorldMax;
+
     Obj3D() {
         transform = glm::mat4(1.0f); // matriz identidade
     }
-};
\ No newline at end of file
+
+    // Recalcula os bounds de mundo a partir dos bounds locais da malha (do
+    // loadOBJ/.smesh) se `transform` ou a malha mudaram desde a ltima
+    // chamada. Objetos parados no pagam nada. Devolve false sem malha.
+    bool updateWorldBounds();
+
+private:
+    const Mesh* boundsMesh = nullptr;
+    glm::mat4 boundsTransform;
+};
@@ -1,61 +1,524 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include "OBJLoader.h"
-#include "MaterialLoader.h"
-#include <fstream>
-#include <sstream>
+#include "AssetCache.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+#include "BinaryMesh.h"
 #include <iostream>
 #include "Material.h"
 #include <vector>
-#include <algorithm>
 #include <map>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+
+// ---------------------------------------------------------------------------
+// Tokenizao in-place sobre o arquivo mapeado: nenhuma alocao por linha,
+// sem stringstream e sem sscanf. Cada funo recebe [p, end) e devolve o
+// ponteiro logo aps o que foi consumido.
+// ---------------------------------------------------------------------------
+
+static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
 
-static void parseFaceToken(const std::string& token, int& v, int& vt, int& vn)
+static inline const char* skipSpaces(const char* p, const char* end)
 {
-    v = vt = vn = -1;
-    int slashCount = std::count(token.begin(), token.end(), '/');
-    if (slashCount == 0)
-    {
-        int r = sscanf(token.c_str(), "%d", &v);
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+    return p;
+}
+
+static inline const char* skipToken(const char* p, const char* end)
+{
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+        p++;
+    return p;
+}
+
+static double pow10i(int e)
+{
+    static const double table[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    if (e >= 0 && e <= 22) return table[e];
+    return std::pow(10.0, (double)e);
+}
+
+static const char* parseFloat(const char* p, const char* end, float& out)
+{
+    p = skipSpaces(p, end);
+
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); p++; }
+
+    uint64_t mant = 0;
+    int exp10 = 0;
+
+    for (; p < end && isDigit(*p); p++) {
+        if (mant < 100000000000000000ULL) mant = mant * 10 + (*p - '0');
+        else exp10++;
     }
-    else if (slashCount == 1)
+
+    if (p < end && *p == '.') {
+        for (p++; p < end && isDigit(*p); p++) {
+            if (mant < 100000000000000000ULL) { mant = mant * 10 + (*p - '0'); exp10--; }
+        }
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool expNeg = false;
+        if (p < end && (*p == '-' || *p == '+')) { expNeg = (*p == '-'); p++; }
+        int e = 0;
+        for (; p < end && isDigit(*p); p++)
+            if (e < 10000) e = e * 10 + (*p - '0');
+        exp10 += expNeg ? -e : e;
+    }
+
+    double v = (double)mant;
+    if (exp10 < 0) v /= pow10i(-exp10);
+    else if (exp10 > 0) v *= pow10i(exp10);
+
+    out = (float)(neg ? -v : v);
+    return p;
+}
+
+static const char* parseInt(const char* p, const char* end, int& out)
+{
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); p++; }
+
+    int v = 0;
+    for (; p < end && isDigit(*p); p++)
+        v = v * 10 + (*p - '0');
+
+    out = neg ? -v : v;
+    return p;
+}
+
+// L um token de face: v, v/vt, v//vn ou v/vt/vn (ndices ainda no formato OBJ,
+// 1-based ou negativos; 0 = ausente).
+static const char* parseFaceToken(const char* p, const char* end, int& v, int& vt, int& vn)
+{
+    v = vt = vn = 0;
+
+    p = parseInt(p, end, v);
+    if (p < end && *p == '/') {
+        p++;
+        if (p < end && *p != '/')
+            p = parseInt(p, end, vt);
+        if (p < end && *p == '/') {
+            p++;
+            p = parseInt(p, end, vn);
+        }
+    }
+
+    return skipToken(p, end);
+}
+
+// OBJ: positivo = 1-based, negativo = relativo ao fim da lista atual
+static inline int resolveIndex(int idx, size_t count)
+{
+    if (idx > 0) return idx - 1;
+    if (idx < 0) return (int)count + idx;
+    return -1;
+}
+
+static inline bool keywordIs(const char* k, size_t len, const char* word)
+{
+    return std::strlen(word) == len && std::memcmp(k, word, len) == 0;
+}
+
+
+// ---------------------------------------------------------------------------
+// Parsing em paralelo: o arquivo  dividido em blocos alinhados em '\n' e
+// cada bloco  lido por uma thread. ndices positivos j so globais; os
+// negativos (relativos) dependem de quantos vrtices vieram antes do bloco,
+// ento ficam anotados em `relative` e so corrigidos no merge.
+//
+// Tudo que o parser produz vai para vetores contguos do bloco (nenhum
+// objeto por tringulo); `allocs` conta quantas vezes algum deles precisou
+// crescer, para acompanhar o custo de alocao do carregamento.
+// ---------------------------------------------------------------------------
+
+struct ObjEvent {
+    enum Type { Mtllib, Usemtl } type;
+    std::string name;
+    size_t cornerOffset;   // quantos cantos do bloco vieram antes do evento
+};
+
+struct ObjChunk {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texcoords;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::ivec3> corners;   // (v, vt, vn), 3 por tringulo
+    std::vector<ObjEvent> events;
+    std::vector<size_t> relative;      // (canto * 3 + atributo) com ndice relativo ao bloco
+    size_t allocs = 0;
+};
+
+template <typename T>
+static inline void pushTracked(std::vector<T>& v, const T& value, size_t& allocs)
+{
+    if (v.size() == v.capacity()) allocs++;
+    v.push_back(value);
+}
+
+// abaixo disso uma thread s  mais rpida que criar as demais
+static const size_t MIN_CHUNK_BYTES = 4 * 1024 * 1024;
+
+static void parseChunk(const char* p, const char* end, ObjChunk& out)
+{
+    // reaproveitado entre linhas: s cresce at o maior polgono do bloco
+    std::vector<glm::ivec3> verts;
+    std::vector<glm::bvec3> vertsRelative;
+
+    while (p < end)
     {
-        int r = sscanf(token.c_str(), "%d/%d", &v, &vt);
+        const char* lineEnd = (const char*)std::memchr(p, '\n', end - p);
+        if (!lineEnd) lineEnd = end;
+
+        const char* k = skipSpaces(p, lineEnd);
+        const char* kEnd = skipToken(k, lineEnd);
+        size_t kLen = kEnd - k;
+        const char* q = kEnd;
+
+        if (kLen == 1 && k[0] == 'v')
+        {
+            glm::vec3 v;
+            q = parseFloat(q, lineEnd, v.x);
+            q = parseFloat(q, lineEnd, v.y);
+            q = parseFloat(q, lineEnd, v.z);
+            pushTracked(out.positions, v, out.allocs);
+        }
+        else if (kLen == 2 && k[0] == 'v' && k[1] == 't')
+        {
+            glm::vec2 t;
+            q = parseFloat(q, lineEnd, t.x);
+            q = parseFloat(q, lineEnd, t.y);
+            pushTracked(out.texcoords, t, out.allocs);
+        }
+        else if (kLen == 2 && k[0] == 'v' && k[1] == 'n')
+        {
+            glm::vec3 n;
+            q = parseFloat(q, lineEnd, n.x);
+            q = parseFloat(q, lineEnd, n.y);
+            q = parseFloat(q, lineEnd, n.z);
+            pushTracked(out.normals, n, out.allocs);
+        }
+        else if (kLen == 1 && k[0] == 'f')
+        {
+            verts.clear();
+            vertsRelative.clear();
+            for (;;)
+            {
+                q = skipSpaces(q, lineEnd);
+                if (q >= lineEnd) break;
+
+                int v, vt, vn;
+                q = parseFaceToken(q, lineEnd, v, vt, vn);
+
+                glm::ivec3 corner(
+                    resolveIndex(v, out.positions.size()),
+                    resolveIndex(vt, out.texcoords.size()),
+                    resolveIndex(vn, out.normals.size()));
+                if (v >= 0 && corner.x < 0) corner.x = 0;
+
+                pushTracked(verts, corner, out.allocs);
+                pushTracked(vertsRelative, glm::bvec3(v < 0, vt < 0, vn < 0), out.allocs);
+            }
+
+            // Triangulao em fan
+            for (size_t i = 1; i + 1 < verts.size(); i++)
+            {
+                const size_t tri[3] = { 0, i, i + 1 };
+                for (size_t c = 0; c < 3; c++)
+                {
+                    for (int a = 0; a < 3; a++)
+                        if (vertsRelative[tri[c]][a])
+                            pushTracked(out.relative, out.corners.size() * 3 + a, out.allocs);
+                    pushTracked(out.corners, verts[tri[c]], out.allocs);
+                }
+            }
+        }
+        else if (keywordIs(k, kLen, "mtllib") || keywordIs(k, kLen, "usemtl"))
+        {
+            q = skipSpaces(q, lineEnd);
+
+            ObjEvent ev;
+            ev.type = (k[0] == 'm') ? ObjEvent::Mtllib : ObjEvent::Usemtl;
+            ev.name.assign(q, skipToken(q, lineEnd));
+            ev.cornerOffset = out.corners.size();
+            pushTracked(out.events, ev, out.allocs);
+        }
+
+        p = lineEnd + 1;
     }
-    else
+}
+
+// ndices que apontam para alm das listas do arquivo: UV/normal viram
+// ausentes; tringulo com posio invlida sai inteiro. Depois disso o
+// buildGPUData pode indexar direto. Devolve quantos tringulos saram.
+static size_t dropInvalidCorners(Mesh* mesh)
+{
+    int numV = (int)mesh->vertices.size();
+    int numT = (int)mesh->texcoords.size();
+    int numN = (int)mesh->normals.size();
+
+    std::vector<size_t> dropped(mesh->groups.size(), 0);
+    parallelFor(mesh->groups.size(), 1, [&](size_t b, size_t e) {
+        for (size_t gi = b; gi < e; gi++)
+        {
+            std::vector<glm::ivec3>& c = mesh->groups[gi]->corners;
+            size_t out = 0;
+            for (size_t t = 0; t + 2 < c.size(); t += 3)
+            {
+                bool valid = true;
+                for (size_t k = t; k < t + 3; k++) {
+                    if (c[k].x < 0 || c[k].x >= numV) valid = false;
+                    if (c[k].y >= numT) c[k].y = -1;
+                    if (c[k].z >= numN) c[k].z = -1;
+                }
+                if (!valid) { dropped[gi]++; continue; }
+                if (out != t) std::copy(c.begin() + t, c.begin() + t + 3, c.begin() + out);
+                out += 3;
+            }
+            c.resize(out);
+        }
+    });
+
+    size_t total = 0;
+    for (size_t d : dropped) total += d;
+    return total;
+}
+
+// Arquivo mapeado -> Mesh com os cantos de cada grupo (sem dados de GPU)
+static Mesh* parseOBJ(const MappedFile& file, const std::string& path)
+{
+    const char* data = file.data();
+    const char* end = data + file.size();
+
+    // fronteiras dos blocos, sempre logo aps um '\n'
+    size_t numChunks = std::min<size_t>(workerCount(), file.size() / MIN_CHUNK_BYTES + 1);
+    std::vector<const char*> bounds;
+    bounds.push_back(data);
+    for (size_t i = 1; i < numChunks; i++)
     {
-        if (token.find("//") != std::string::npos)
+        const char* b = data + file.size() * i / numChunks;
+        if (b < bounds.back()) b = bounds.back();
+        const char* nl = (const char*)std::memchr(b, '\n', end - b);
+        b = nl ? nl + 1 : end;
+        if (b > bounds.back() && b < end) bounds.push_back(b);
+    }
+    bounds.push_back(end);
+    numChunks = bounds.size() - 1;
+
+    std::vector<ObjChunk> chunks(numChunks);
+    parallelFor(numChunks, 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; i++)
+            parseChunk(bounds[i], bounds[i + 1], chunks[i]);
+    });
+
+    // ---- merge: numerao global de vrtices + mesma ordem de grupos ----
+
+    size_t allocs = 0;
+    for (const ObjChunk& c : chunks) allocs += c.allocs;
+
+    Mesh* mesh = new Mesh();
+
+    // base global de v / vt / vn de cada bloco
+    std::vector<glm::ivec3> base(numChunks + 1, glm::ivec3(0));
+    for (size_t i = 0; i < numChunks; i++)
+        base[i + 1] = base[i] + glm::ivec3((int)chunks[i].positions.size(),
+                                           (int)chunks[i].texcoords.size(),
+                                           (int)chunks[i].normals.size());
+
+    mesh->vertices.resize(base[numChunks].x);
+    mesh->texcoords.resize(base[numChunks].y);
+    mesh->normals.resize(base[numChunks].z);
+    allocs += 3;
+
+    parallelFor(numChunks, 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; i++)
         {
-            int r = sscanf(token.c_str(), "%d//%d", &v, &vn);
+            ObjChunk& c = chunks[i];
+            std::copy(c.positions.begin(), c.positions.end(), mesh->vertices.begin() + base[i].x);
+            std::copy(c.texcoords.begin(), c.texcoords.end(), mesh->texcoords.begin() + base[i].y);
+            std::copy(c.normals.begin(), c.normals.end(), mesh->normals.begin() + base[i].z);
+            for (size_t r : c.relative) {
+                int attr = (int)(r % 3);
+                int& idx = c.corners[r / 3][attr];
+                idx += base[i][attr];
+                if (idx < 0) idx = (attr == 0) ? 0 : -1;
+            }
+            std::vector<glm::vec3>().swap(c.positions);
+            std::vector<glm::vec2>().swap(c.texcoords);
+            std::vector<glm::vec3>().swap(c.normals);
         }
-        else
+    });
+
+    // Passo 1 (serial, sem tocar nos cantos): repete os eventos em ordem de
+    // arquivo para montar a sequncia de grupos e os trechos de cada bloco.
+    struct Segment { size_t chunk, begin, end, group, dst; };
+    std::vector<Segment> segments;
+
+    Group* currentGroup = new Group();
+    currentGroup->name = "default";
+    mesh->groups.push_back(currentGroup);
+
+    std::map<std::string, Material*> materials;
+    Material* currentMaterial = nullptr;
+
+    size_t lastSlash = path.find_last_of("/\\");
+    std::string dir = (lastSlash != std::string::npos) ? path.substr(0, lastSlash + 1) : "";
+
+    for (size_t ci = 0; ci < numChunks; ci++)
+    {
+        const ObjChunk& c = chunks[ci];
+        size_t cursor = 0;
+        for (size_t e = 0; e <= c.events.size(); e++)
         {
-            int r = sscanf(token.c_str(), "%d/%d/%d", &v, &vt, &vn);
+            size_t until = (e < c.events.size()) ? c.events[e].cornerOffset : c.corners.size();
+            if (until > cursor)
+                segments.push_back({ ci, cursor, until, mesh->groups.size() - 1, 0 });
+            cursor = until;
+
+            if (e == c.events.size()) break;
+            const ObjEvent& ev = c.events[e];
+
+            if (ev.type == ObjEvent::Mtllib)
+            {
+                std::string mtlPath = dir + ev.name;
+
+                std::cout << "[OBJ] Carregando MTL: " << mtlPath << std::endl;
+                materials = acquireMaterials(mtlPath);
+                mesh->mtlLibs.push_back(mtlPath);
+
+                if (materials.empty()) {
+                    std::cerr << "[OBJ] AVISO: Nenhum material carregado de " << mtlPath << std::endl;
+                }
+            }
+            else
+            {
+                auto it = materials.find(ev.name);
+                if (it != materials.end())
+                {
+                    currentMaterial = it->second;
+
+                    currentGroup = new Group();
+                    currentGroup->name = ev.name;
+                    currentGroup->material = currentMaterial;
+                    currentGroup->materialLib = (int)mesh->mtlLibs.size() - 1;
+                    mesh->groups.push_back(currentGroup);
+
+                    std::cout << "[OBJ] Usando material: " << ev.name << std::endl;
+                }
+                else
+                {
+                    std::cerr << "[OBJ] AVISO: Material '" << ev.name << "' no encontrado!" << std::endl;
+                }
+            }
         }
     }
-    
-    if (v > 0) v--; else v = 0;
-    if (vt > 0) vt--; else vt = -1;
-    if (vn > 0) vn--; else vn = -1;
+
+    // Passo 2: tamanho final de cada grupo -> uma nica alocao por grupo
+    std::vector<size_t> groupSize(mesh->groups.size(), 0);
+    for (Segment& s : segments) {
+        s.dst = groupSize[s.group];
+        groupSize[s.group] += s.end - s.begin;
+    }
+    for (size_t g = 0; g < mesh->groups.size(); g++) {
+        allocs++;   // o prprio Group
+        if (groupSize[g] == 0) continue;
+        mesh->groups[g]->corners.resize(groupSize[g]);
+        allocs++;
+    }
+
+    // Passo 3: cpia dos trechos para os grupos, em paralelo
+    parallelFor(segments.size(), 64, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; i++)
+        {
+            const Segment& s = segments[i];
+            const ObjChunk& c = chunks[s.chunk];
+            std::copy(c.corners.begin() + s.begin, c.corners.begin() + s.end,
+                      mesh->groups[s.group]->corners.begin() + s.dst);
+        }
+    });
+
+    size_t invalid = dropInvalidCorners(mesh);
+    if (invalid > 0)
+        std::cerr << "[OBJ] AVISO: " << invalid << " tringulo(s) com ndice de vrtice invlido ignorado(s): " << path << std::endl;
+
+    size_t totalFaces = 0;
+    for (auto g : mesh->groups) totalFaces += g->corners.size() / 3;
+
+    std::cout << "---- OBJ Carregado ----\n";
+    std::cout << "Arquivo: " << path << "\n";
+    std::cout << "Vrtices: " << mesh->vertices.size() << "\n";
+    std::cout << "Faces: " << totalFaces << "\n";
+    std::cout << "Grupos/Materiais: " << mesh->groups.size() << "\n";
+    std::cout << "Blocos de parsing: " << numChunks << "\n";
+    std::cout << "Alocaes no carregamento: " << allocs << "\n";
+    std::cout << "-----------------------\n";
+
+    return mesh;
 }
 
 Obj3D* loadOBJ(const std::string& path)
 {
-    std::ifstream file(path);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.open(path)) {
         std::cerr << "ERRO: No foi possvel abrir OBJ: " << path << std::endl;
         return nullptr;
     }
 
+    Mesh* mesh = parseOBJ(file, path);
+    mesh->buildGPUData();
+    writeBinaryMesh(path, mesh, hashBytes(file.data(), file.size()), file.size());
+
+    Obj3D* obj = new Obj3D();
+    obj->mesh = mesh;
+    obj->mesh->uploadToGPU();
+
+    return obj;
+}
+
+// ---------------------------------------------------------------------------
+// Comparao com o parser antigo (getline + stringstream + sscanf por token),
+// mantido s como referncia para o benchmark.
+// ---------------------------------------------------------------------------
+
+static void parseFaceTokenStream(const std::string& token, int& v, int& vt, int& vn)
+{
+    v = vt = vn = 0;
+    int slashCount = (int)std::count(token.begin(), token.end(), '/');
+    if (slashCount == 0)
+        sscanf(token.c_str(), "%d", &v);
+    else if (slashCount == 1)
+        sscanf(token.c_str(), "%d/%d", &v, &vt);
+    else if (token.find("//") != std::string::npos)
+        sscanf(token.c_str(), "%d//%d", &v, &vn);
+    else
+        sscanf(token.c_str(), "%d/%d/%d", &v, &vt, &vn);
+}
+
+static Mesh* parseOBJStream(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) return nullptr;
+
     Mesh* mesh = new Mesh();
     Group* currentGroup = new Group();
     currentGroup->name = "default";
     mesh->groups.push_back(currentGroup);
 
-    std::vector<glm::vec3> tmpV;
-    
     std::map<std::string, Material*> materials;
-    Material* currentMaterial = nullptr;
-    
+
     size_t lastSlash = path.find_last_of("/\\");
     std::string dir = (lastSlash != std::string::npos) ? path.substr(0, lastSlash + 1) : "";
 
@@ -70,85 +533,201 @@ Obj3D* loadOBJ(const std::string& path)
         {
             std::string mtlFile;
             ss >> mtlFile;
-            std::string mtlPath = dir + mtlFile;
-            
-            std::cout << "[OBJ] Carregando MTL: " << mtlPath << std::endl;
-            materials = loadMTL(mtlPath);
-            
-            if (materials.empty()) {
-                std::cerr << "[OBJ] AVISO: Nenhum material carregado de " << mtlPath << std::endl;
-            }
+            materials = acquireMaterials(dir + mtlFile);
+            mesh->mtlLibs.push_back(dir + mtlFile);
         }
         else if (type == "usemtl")
         {
             std::string matName;
             ss >> matName;
-            
-            if (materials.find(matName) != materials.end())
+            auto it = materials.find(matName);
+            if (it != materials.end())
             {
-                currentMaterial = materials[matName];
-                
                 currentGroup = new Group();
                 currentGroup->name = matName;
-                currentGroup->material = currentMaterial;
+                currentGroup->material = it->second;
+                currentGroup->materialLib = (int)mesh->mtlLibs.size() - 1;
                 mesh->groups.push_back(currentGroup);
-                
-                std::cout << "[OBJ] Usando material: " << matName << std::endl;
-            }
-            else
-            {
-                std::cerr << "[OBJ] AVISO: Material '" << matName << "' no encontrado!" << std::endl;
             }
         }
         else if (type == "v")
         {
             glm::vec3 v;
             ss >> v.x >> v.y >> v.z;
-            tmpV.push_back(v);
+            mesh->vertices.push_back(v);
+        }
+        else if (type == "vt")
+        {
+            glm::vec2 t;
+            ss >> t.x >> t.y;
+            mesh->texcoords.push_back(t);
+        }
+        else if (type == "vn")
+        {
+            glm::vec3 n;
+            ss >> n.x >> n.y >> n.z;
+            mesh->normals.push_back(n);
         }
         else if (type == "f")
         {
-            std::vector<std::string> tokens;
-            std::string t;
-            while (ss >> t)
-                tokens.push_back(t);
-
-            if (tokens.size() < 3) continue;
-
-            std::vector<int> verts;
-            verts.reserve(tokens.size());
-            for (auto& tok : tokens)
+            std::vector<glm::ivec3> verts;
+            std::string tok;
+            while (ss >> tok)
             {
                 int v, vt, vn;
-                parseFaceToken(tok, v, vt, vn);
-                verts.push_back(v);
+                parseFaceTokenStream(tok, v, vt, vn);
+                glm::ivec3 c(resolveIndex(v, mesh->vertices.size()),
+                             resolveIndex(vt, mesh->texcoords.size()),
+                             resolveIndex(vn, mesh->normals.size()));
+                if (c.x < 0) c.x = 0;
+                if (c.y < 0) c.y = -1;
+                if (c.z < 0) c.z = -1;
+                verts.push_back(c);
             }
 
             // Triangulao em fan
             for (size_t i = 1; i + 1 < verts.size(); i++)
             {
-                Face* f = new Face();
-                f->v = { verts[0], verts[i], verts[i + 1] };
-                currentGroup->faces.push_back(f);
+                currentGroup->corners.push_back(verts[0]);
+                currentGroup->corners.push_back(verts[i]);
+                currentGroup->corners.push_back(verts[i + 1]);
             }
         }
     }
+    dropInvalidCorners(mesh);
+    return mesh;
+}
 
-    mesh->vertices = tmpV;
+// floats iguais at o ltimo dgito que o .obj costuma trazer;
+// com n == 0 os ponteiros (talvez nulos) no so lidos
+static bool sameFloats(const float* a, const float* b, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        if (std::fabs(a[i] - b[i]) > 1e-6f * std::max(1.0f, std::fabs(a[i])))
+            return false;
+    return true;
+}
 
-    size_t totalFaces = 0;
-    for (auto g : mesh->groups) totalFaces += g->faces.size();
+// Primeira diferena entre as duas malhas, ou vazio se so iguais
+static std::string compareMeshes(const Mesh* a, const Mesh* b)
+{
+    if (a->vertices.size() != b->vertices.size() ||
+        !sameFloats((const float*)a->vertices.data(), (const float*)b->vertices.data(), a->vertices.size() * 3))
+        return "posies";
+    if (a->texcoords.size() != b->texcoords.size() ||
+        !sameFloats((const float*)a->texcoords.data(), (const float*)b->texcoords.data(), a->texcoords.size() * 2))
+        return "coordenadas de textura";
+    if (a->normals.size() != b->normals.size() ||
+        !sameFloats((const float*)a->normals.data(), (const float*)b->normals.data(), a->normals.size() * 3))
+        return "normais";
+    if (a->groups.size() != b->groups.size())
+        return "nmero de grupos";
+    for (size_t g = 0; g < a->groups.size(); g++)
+    {
+        const Group* ga = a->groups[g];
+        const Group* gb = b->groups[g];
+        if (ga->name != gb->name || ga->material != gb->material)
+            return "material do grupo " + ga->name;
+        if (ga->corners != gb->corners)
+            return "faces do grupo " + ga->name;
+    }
+    return "";
+}
 
-    std::cout << "---- OBJ Carregado ----\n";
-    std::cout << "Arquivo: " << path << "\n";
-    std::cout << "Vrtices: " << mesh->vertices.size() << "\n";
-    std::cout << "Faces: " << totalFaces << "\n";
-    std::cout << "Grupos/Materiais: " << mesh->groups.size() << "\n";
-    std::cout << "-----------------------\n";
+template <typename F>
+static double timeMs(F&& f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
 
-    Obj3D* obj = new Obj3D();
-    obj->mesh = mesh;
-    obj->mesh->uploadToGPU();
+static void releaseParsed(Mesh* mesh)
+{
+    if (!mesh) return;
+    for (const std::string& lib : mesh->mtlLibs) releaseMaterials(lib);
+    delete mesh;
+}
 
-    return obj;
-}
\ No newline at end of file
+bool benchmarkOBJLoaders(const std::string& path)
+{
+    Mesh* before = nullptr;
+    Mesh* after = nullptr;
+
+    double streamMs = timeMs([&] { before = parseOBJStream(path); });
+    double mappedMs = timeMs([&] {
+        MappedFile file;
+        if (file.open(path)) after = parseOBJ(file, path);
+    });
+
+    bool ok = before && after;
+    if (!ok) std::cerr << "[OBJ bench] No foi possvel abrir " << path << std::endl;
+    else
+    {
+        size_t faces = 0;
+        for (const Group* g : after->groups) faces += g->corners.size() / 3;
+
+        std::string diff = compareMeshes(before, after);
+        ok = diff.empty();
+        std::cout << "[OBJ bench] " << path << ": " << faces << " tringulos\n"
+            << "  getline/stringstream: " << streamMs << " ms\n"
+            << "  mapeado em paralelo:  " << mappedMs << " ms (" << streamMs / std::max(mappedMs, 0.001) << "x)\n"
+            << "  sada " << (ok ? "idntica" : "DIFERENTE em: " + diff) << std::endl;
+    }
+
+    releaseParsed(before);
+    releaseParsed(after);
+    return ok;
+}
+
+bool writeSyntheticOBJ(const std::string& path, size_t faces)
+{
+    // grade quadrada de clulas com dois tringulos cada
+    size_t cells = (faces + 1) / 2;
+    size_t side = (size_t)std::ceil(std::sqrt((double)cells));
+    size_t rows = (cells + side - 1) / side;
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        std::cerr << "[OBJ bench] No foi possvel criar " << path << std::endl;
+        return false;
+    }
+
+    // dois materiais: metade das linhas para cada grupo
+    std::string mtlPath = path.substr(0, path.find_last_of('.')) + ".mtl";
+    size_t slash = mtlPath.find_last_of("/\\");
+    std::string mtlName = (slash != std::string::npos) ? mtlPath.substr(slash + 1) : mtlPath;
+    if (FILE* m = std::fopen(mtlPath.c_str(), "wb")) {
+        std::fprintf(m, "newmtl bench_a\nKd 0.8 0.2 0.2\nnewmtl bench_b\nKd 0.2 0.2 0.8\n");
+        std::fclose(m);
+    }
+    std::fprintf(f, "# grade sinttica: %zu tringulos\nmtllib %s\n", faces, mtlName.c_str());
+
+    for (size_t y = 0; y <= rows; y++)
+        for (size_t x = 0; x <= side; x++)
+            std::fprintf(f, "v %.6f %.6f %.6f\n", (float)x / side, 0.05f * std::sin(x * 0.1f + y * 0.07f), (float)y / side);
+    for (size_t y = 0; y <= rows; y++)
+        for (size_t x = 0; x <= side; x++)
+            std::fprintf(f, "vt %.6f %.6f\n", (float)x / side, (float)y / rows);
+    std::fprintf(f, "vn 0 1 0\n");
+
+    size_t written = 0;
+    for (size_t y = 0; y < rows && written < faces; y++)
+    {
+        if (y == 0) std::fprintf(f, "usemtl bench_a\n");
+        if (y == rows / 2) std::fprintf(f, "usemtl bench_b\n");
+        for (size_t x = 0; x < side && written < faces; x++)
+        {
+            size_t a = y * (side + 1) + x + 1;   // 1-based
+            size_t b = a + 1, c = a + side + 1, d = c + 1;
+            std::fprintf(f, "f %zu/%zu/1 %zu/%zu/1 %zu/%zu/1\n", a, a, c, c, b, b);
+            if (++written < faces)
+                std::fprintf(f, "f %zu/%zu/-1 %zu/%zu/-1 %zu/%zu/-1\n", b, b, c, c, d, d);
+            ++written;
+        }
+    }
+
+    std::fclose(f);
+    std::cout << "[OBJ bench] " << path << " gerado (" << written << " tringulos)" << std::endl;
+    return true;
+}
@@ -2,4 +2,12 @@
 #include <string>
 #include "Obj3D.h"
 
-Obj3D* loadOBJ(const std::string& path);
\ No newline at end of file
+Obj3D* loadOBJ(const std::string& path);
+
+// Benchmark do parser: l `path` com o loader mapeado e com o antigo
+// (getline/stringstream), mostra os tempos e confere se a sada  a mesma.
+bool benchmarkOBJLoaders(const std::string& path);
+
+// OBJ de teste: grade com `faces` tringulos (v/vt/vn, ndices absolutos e
+// relativos, dois materiais num .mtl ao lado).
+bool writeSyntheticOBJ(const std::string& path, size_t faces);
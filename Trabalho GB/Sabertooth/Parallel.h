@@ -0,0 +1,38 @@
+#pragma once
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Nmero de threads de trabalho disponveis (no mnimo 1).
+inline unsigned workerCount()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+// Divide [0, count) em faixas contguas e chama fn(begin, end) em paralelo,
+// uma faixa por thread. Faixas menores que minPerWorker no compensam uma
+// thread nova; nesse caso tudo roda na thread chamadora.
+template <typename Fn>
+void parallelFor(size_t count, size_t minPerWorker, Fn fn)
+{
+    if (count == 0) return;
+    if (minPerWorker == 0) minPerWorker = 1;
+
+    size_t workers = std::min<size_t>(workerCount(), (count + minPerWorker - 1) / minPerWorker);
+    if (workers <= 1) {
+        fn((size_t)0, count);
+        return;
+    }
+
+    size_t step = (count + workers - 1) / workers;
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t b = step; b < count; b += step)
+        threads.emplace_back(fn, b, std::min(count, b + step));
+
+    fn((size_t)0, std::min(count, step));
+
+    for (auto& t : threads) t.join();
+}
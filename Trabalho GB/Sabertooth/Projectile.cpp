@@ -23,8 +23,10 @@ void ProjectileManager::update(float deltaTime, float currentTime)
         Projectile& p = projectiles[i];
         float life = currentTime - p.spawnTime;
 
+        // troca com o ltimo: a ordem no importa para o desenho instanciado
         if (life > 2.0f) {
-            projectiles.erase(projectiles.begin() + i);
+            p = projectiles.back();
+            projectiles.pop_back();
             continue;
         }
 
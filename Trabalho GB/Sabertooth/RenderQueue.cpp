@@ -0,0 +1,430 @@
+#include "RenderQueue.h"
+#include "MaterialTable.h"
+#include "TextureArrays.h"
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/type_ptr.hpp>
+
+struct DrawPacket {
+    const ShaderProgram* program;
+    const Group* group;
+    int lod;
+    const glm::mat4* model;       // sem instncias
+    Mesh* mesh;                   // com instncias: dona do VBO de instncias
+    const glm::mat4* instances;
+    int instanceCount;
+};
+
+struct SortItem {
+    uint64_t key;
+    uint32_t packet;
+};
+
+// Registro por instncia do bloco Draws (std430, igual ao core_indirect.vert)
+struct DrawData {
+    glm::mat4 model;
+    glm::vec4 posScale;
+    glm::vec4 posBias;
+    glm::ivec4 info;   // material, hasTexCoords
+};
+
+// Formato do GL para glMultiDrawElementsIndirect
+struct DrawCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;   // primeiro registro em Draws
+};
+
+// Pacotes seguidos (na ordem da fila) desenhados por um multi-draw
+struct IndirectRun {
+    size_t packetCount;
+    size_t firstCommand;
+    size_t commandCount;
+    size_t instances;
+};
+
+static std::vector<DrawPacket> packets;
+static std::vector<SortItem> items, scratch;
+static std::vector<GLuint> programOrder;   // ndice do programa na chave
+static glm::mat4 viewMatrix(1.0f);
+static RenderQueueStats stats;
+
+static std::vector<DrawData> drawData;
+static std::vector<DrawCommand> commands;
+static std::vector<IndirectRun> runs;
+static GLuint drawBuffer = 0;       // SSBO do bloco Draws
+static GLuint commandBuffer = 0;    // GL_DRAW_INDIRECT_BUFFER
+static GLuint drawIndexBuffer = 0;  // 0, 1, 2, ... para aDrawIndex
+static size_t drawIndexCapacity = 0;
+
+static uint64_t programSlot(GLuint id)
+{
+    for (size_t i = 0; i < programOrder.size(); i++)
+        if (programOrder[i] == id) return i;
+    programOrder.push_back(id);
+    return programOrder.size() - 1;
+}
+
+// Bits de um float positivo crescem junto com o valor: os 24 de cima bastam
+static uint64_t depthBits(float depth)
+{
+    if (!(depth > 0.0f)) return 0;
+    uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+    return bits >> 8;
+}
+
+static uint64_t makeKey(RenderPass pass, const ShaderProgram& program, const Group* g, float depth)
+{
+    const Texture* tex = g->material ? g->material->texture : nullptr;
+    uint64_t key = 0;
+    key |= (uint64_t)(pass & 0x3) << 62;
+    key |= (programSlot(program.id) & 0x3F) << 56;
+    key |= (uint64_t)(standaloneTexture(tex) & 0x3FF) << 46;
+    if (!program.indirect)
+        key |= (uint64_t)(materialIndex(g->material) & 0xFF) << 38;
+    key |= (uint64_t)(g->VAO & 0x3FFF) << 24;
+    key |= depthBits(depth);
+    return key;
+}
+
+bool indirectDrawSupported()
+{
+    return GLEW_VERSION_4_3 != 0;
+}
+
+void beginRenderQueue(const glm::mat4& view)
+{
+    packets.clear();
+    items.clear();
+    viewMatrix = view;
+}
+
+static void submit(const DrawPacket& p, RenderPass pass, float depth)
+{
+    if (!p.group->VAO) return;   // ainda na fila de upload
+
+    // o grupo vai ser desenhado: textura pedida/mantida pelo oramento
+    if (p.group->material && p.group->material->texture)
+        touchTexture(p.group->material->texture);
+
+    items.push_back({ makeKey(pass, *p.program, p.group, depth), (uint32_t)packets.size() });
+    packets.push_back(p);
+}
+
+void submitGroup(const ShaderProgram& program, const Group* g, int lod, const glm::mat4* model, RenderPass pass)
+{
+    // distncia do centro do grupo  cmera, no espao de viso
+    glm::vec3 center = (g->boundsMin + g->boundsMax) * 0.5f;
+    float depth = -(viewMatrix * (*model * glm::vec4(center, 1.0f))).z;
+
+    submit({ &program, g, lod, model, nullptr, nullptr, 0 }, pass, depth);
+}
+
+void submitInstanced(const ShaderProgram& program, Mesh* mesh, const Group* g, int lod,
+                     const glm::mat4* models, int count, RenderPass pass)
+{
+    if (count <= 0) return;
+
+    glm::vec3 center = (g->boundsMin + g->boundsMax) * 0.5f;
+    float depth = -(viewMatrix * (models[0] * glm::vec4(center, 1.0f))).z;
+
+    submit({ &program, g, lod, nullptr, mesh, models, count }, pass, depth);
+}
+
+// LSD de 8 bits; passadas em que todas as chaves tm o mesmo byte so puladas
+static void radixSort(std::vector<SortItem>& a, std::vector<SortItem>& tmp)
+{
+    size_t n = a.size();
+    if (n < 2) return;
+    tmp.resize(n);
+
+    size_t counts[8][256];
+    std::memset(counts, 0, sizeof(counts));
+    for (const SortItem& it : a)
+        for (int d = 0; d < 8; d++)
+            counts[d][(it.key >> (d * 8)) & 0xFF]++;
+
+    for (int d = 0; d < 8; d++)
+    {
+        size_t* c = counts[d];
+        if (c[(a[0].key >> (d * 8)) & 0xFF] == n) continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; b++) {
+            size_t count = c[b];
+            c[b] = offset;
+            offset += count;
+        }
+        for (const SortItem& it : a)
+            tmp[c[(it.key >> (d * 8)) & 0xFF]++] = it;
+        a.swap(tmp);
+    }
+}
+
+// Estado j enviado ao GL neste flush
+struct ReplayState {
+    GLuint program = 0;
+    GLuint vao = 0;
+    GLuint texture = 0;
+    int material = -1;
+    int instanced = -1;
+    int hasTexCoords = -1;
+    glm::vec3 posScale = glm::vec3(NAN);
+    glm::vec3 posBias = glm::vec3(NAN);
+    const glm::mat4* model = nullptr;
+};
+
+static GLuint packetTexture(const DrawPacket& p)
+{
+    return standaloneTexture(p.group->material ? p.group->material->texture : nullptr);
+}
+
+static void appendDrawData(const DrawPacket& p, const glm::mat4& model)
+{
+    const Group* g = p.group;
+    drawData.push_back({ model, glm::vec4(g->posScale, 0.0f), glm::vec4(g->posBias, 0.0f),
+                         glm::ivec4(materialIndex(g->material), g->hasTexCoords ? 1 : 0, 0, 0) });
+}
+
+// Monta comandos e registros de todos os pacotes indiretos da fila j
+// ordenada e envia os dois buffers de uma vez, antes de qualquer draw.
+static void buildIndirectRuns()
+{
+    drawData.clear();
+    commands.clear();
+    runs.clear();
+
+    const DrawPacket* prev = nullptr;
+    for (const SortItem& it : items)
+    {
+        const DrawPacket& p = packets[it.packet];
+        if (!p.program->indirect) {
+            prev = nullptr;
+            continue;
+        }
+
+        // mesmo VAO: mesmos buffers e mesmo tipo de ndice
+        bool sameRun = prev && prev->program->id == p.program->id && prev->group->VAO == p.group->VAO
+            && packetTexture(*prev) == packetTexture(p);
+        if (!sameRun)
+            runs.push_back({ 0, commands.size(), 0, 0 });
+        prev = &p;
+
+        const Group* g = p.group;
+        size_t indexSize = (g->indexType == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+        GLuint count = p.instances ? (GLuint)p.instanceCount : 1;
+
+        IndirectRun& run = runs.back();
+        run.packetCount++;
+        run.commandCount++;
+        run.instances += count;
+
+        commands.push_back({ (GLuint)g->lodIndexCount(p.lod), count,
+                             (GLuint)((size_t)g->lodIndexOffset(p.lod) / indexSize), 0, (GLuint)drawData.size() });
+        if (p.instances) {
+            for (int i = 0; i < p.instanceCount; i++)
+                appendDrawData(p, p.instances[i]);
+        }
+        else {
+            appendDrawData(p, *p.model);
+        }
+    }
+
+    if (commands.empty()) return;
+
+    if (!drawBuffer) {
+        glGenBuffers(1, &drawBuffer);
+        glGenBuffers(1, &commandBuffer);
+        glGenBuffers(1, &drawIndexBuffer);
+    }
+
+    // mesmo nome de buffer ao crescer: os VAOs que j apontam para ele continuam valendo
+    if (drawData.size() > drawIndexCapacity) {
+        drawIndexCapacity = std::max(drawData.size(), drawIndexCapacity * 2);
+        std::vector<GLuint> ids(drawIndexCapacity);
+        for (size_t i = 0; i < ids.size(); i++) ids[i] = (GLuint)i;
+        glBindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, ids.size() * sizeof(GLuint), ids.data(), GL_STATIC_DRAW);
+    }
+
+    // realocados a cada frame: o driver no espera os draws do frame anterior
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, drawData.size() * sizeof(DrawData), drawData.data(), GL_STREAM_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAWS_BINDING, drawBuffer);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawCommand), commands.data(), GL_STREAM_DRAW);
+}
+
+static void drawIndirectRun(const IndirectRun& run, const DrawPacket& p, ReplayState& cur, RenderQueueStats& s)
+{
+    const Group* g = p.group;
+
+    if (g->VAO != cur.vao) {
+        glBindVertexArray(g->VAO);
+        cur.vao = g->VAO;
+        s.vaoBinds++;
+    }
+
+    // aDrawIndex no VAO do grupo; refeito a cada sequncia (poucas por
+    // frame) para valer tambm em VAOs criados depois ou com nome reusado
+    glBindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer);
+    glEnableVertexAttribArray(DRAW_INDEX_ATTRIB);
+    glVertexAttribIPointer(DRAW_INDEX_ATTRIB, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+    glVertexAttribDivisor(DRAW_INDEX_ATTRIB, 1);
+
+    GLuint tex = packetTexture(p);
+    if (tex && tex != cur.texture) {
+        glBindTexture(GL_TEXTURE_2D, tex);
+        cur.texture = tex;
+        s.textureBinds++;
+    }
+
+    glMultiDrawElementsIndirect(GL_TRIANGLES, g->indexType,
+        (void*)(run.firstCommand * sizeof(DrawCommand)), (GLsizei)run.commandCount, 0);
+
+    s.draws++;
+    s.commands += run.commandCount;
+    s.instances += run.instances;
+}
+
+void flushRenderQueue()
+{
+    radixSort(items, scratch);
+    buildIndirectRuns();
+
+    RenderQueueStats s;
+    s.packets = packets.size();
+
+    ReplayState cur;
+    std::map<Mesh*, const glm::mat4*> instanceSource;   // o que est no VBO de cada malha
+    size_t nextRun = 0;
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const DrawPacket& p = packets[items[i].packet];
+        const ShaderProgram& prog = *p.program;
+        const Group* g = p.group;
+
+        // uniforms so do programa: trocar de programa esquece os anteriores
+        if (prog.id != cur.program) {
+            glUseProgram(prog.id);
+            ReplayState next;
+            next.program = prog.id;
+            next.vao = cur.vao;
+            next.texture = cur.texture;
+            cur = next;
+            s.programChanges++;
+        }
+
+        if (prog.indirect)
+        {
+            const IndirectRun& run = runs[nextRun++];
+            drawIndirectRun(run, p, cur, s);
+            i += run.packetCount - 1;
+            continue;
+        }
+
+        if (p.instances)
+        {
+            // malhas em mais de um nvel de detalhe reenviam ao alternar;
+            // ao crescer, setInstances religa os VAOs da malha
+            const glm::mat4*& source = instanceSource[p.mesh];
+            if (source != p.instances) {
+                p.mesh->setInstances(p.instances, p.instanceCount);
+                source = p.instances;
+                cur.vao = 0;
+                s.instanceUploads++;
+            }
+        }
+
+        if (g->VAO != cur.vao) {
+            glBindVertexArray(g->VAO);
+            cur.vao = g->VAO;
+            s.vaoBinds++;
+        }
+
+        // arrays e atlas j ligados no incio do frame; s a avulsa troca
+        GLuint tex = packetTexture(p);
+        if (tex && tex != cur.texture) {
+            glBindTexture(GL_TEXTURE_2D, tex);
+            cur.texture = tex;
+            s.textureBinds++;
+        }
+
+        int mat = materialIndex(g->material);
+        if (mat != cur.material) {
+            glUniform1i(prog.loc[UNIFORM_MATERIAL_INDEX], mat);
+            cur.material = mat;
+            s.materialChanges++;
+        }
+
+        if (g->posScale != cur.posScale) {
+            glUniform3fv(prog.loc[UNIFORM_POS_SCALE], 1, glm::value_ptr(g->posScale));
+            cur.posScale = g->posScale;
+            s.uniformUploads++;
+        }
+        if (g->posBias != cur.posBias) {
+            glUniform3fv(prog.loc[UNIFORM_POS_BIAS], 1, glm::value_ptr(g->posBias));
+            cur.posBias = g->posBias;
+            s.uniformUploads++;
+        }
+        if ((int)g->hasTexCoords != cur.hasTexCoords) {
+            glUniform1i(prog.loc[UNIFORM_HAS_TEX_COORDS], g->hasTexCoords);
+            cur.hasTexCoords = g->hasTexCoords;
+            s.uniformUploads++;
+        }
+
+        int instanced = p.instances ? 1 : 0;
+        if (instanced != cur.instanced) {
+            glUniform1i(prog.loc[UNIFORM_INSTANCED], instanced);
+            cur.instanced = instanced;
+            s.uniformUploads++;
+        }
+
+        if (p.instances)
+        {
+            glDrawElementsInstanced(GL_TRIANGLES, g->lodIndexCount(p.lod), g->indexType,
+                g->lodIndexOffset(p.lod), p.instanceCount);
+            s.instances += p.instanceCount;
+        }
+        else
+        {
+            if (p.model != cur.model) {
+                glUniformMatrix4fv(prog.loc[UNIFORM_MODEL], 1, GL_FALSE, glm::value_ptr(*p.model));
+                cur.model = p.model;
+                s.uniformUploads++;
+            }
+
+            glDrawElements(GL_TRIANGLES, g->lodIndexCount(p.lod), g->indexType, g->lodIndexOffset(p.lod));
+            s.instances++;
+        }
+        s.draws++;
+        s.commands++;
+    }
+
+    glBindVertexArray(0);
+    stats = s;
+}
+
+RenderQueueStats renderQueueStats()
+{
+    return stats;
+}
+
+void printRenderQueueStats()
+{
+    const RenderQueueStats& s = stats;
+    std::cout << "[Render] " << s.packets << " pacotes, " << s.draws << " draws (" << s.commands << " comandos), "
+        << s.instances << " instncias; trocas: "
+        << s.programChanges << " programa, " << s.vaoBinds << " VAO, " << s.textureBinds << " textura, "
+        << s.materialChanges << " material, " << s.uniformUploads << " uniforms, " << s.instanceUploads << " envios de instncias\n";
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "ShaderProgram.h"
+#include "Mesh.h"
+
+// Fila de desenho do frame: cada grupo visvel vira um pacote com uma chave
+// de 64 bits (passe, programa, textura avulsa, material, VAO, profundidade).
+// No fim do frame os pacotes so ordenados por radix sort e desenhados em
+// ordem, pulando toda troca de estado que repete a anterior.
+//
+//   bits 63-62  passe
+//   bits 61-56  programa (ndice na ordem de primeiro uso)
+//   bits 55-46  textura avulsa (a nica que ainda exige bind por draw)
+//   bits 45-38  material (ndice na tabela de materiais)
+//   bits 37-24  VAO
+//   bits 23-0   profundidade, da frente para trs
+//
+// A textura vem antes do material: cada material tem uma textura s, mas
+// materiais diferentes podem dividir a mesma.
+//
+// Programas indiretos (ShaderProgram::indirect, GL 4.3+) no usam uniforms
+// por draw: modelo, quantizao, material e hasTexCoords de cada instncia
+// vo para um SSBO (bloco Draws), e cada sequncia de pacotes com o mesmo
+// programa, VAO e textura avulsa vira um glMultiDrawElementsIndirect. Na
+// chave deles o material fica zerado, para no separar as sequncias.
+
+#define DRAWS_BINDING 3       // bloco Draws do core_indirect.vert
+#define DRAW_INDEX_ATTRIB 7   // aDrawIndex: 0, 1, 2, ... com divisor 1
+
+enum RenderPass {
+    PASS_OPAQUE = 0
+};
+
+struct RenderQueueStats {
+    size_t packets = 0;          // pacotes enfileirados
+    size_t draws = 0;            // chamadas de draw (multi-draw conta 1)
+    size_t commands = 0;         // comandos dentro dos multi-draws indiretos
+    size_t instances = 0;        // instncias desenhadas (1 por draw simples)
+    size_t programChanges = 0;
+    size_t vaoBinds = 0;
+    size_t textureBinds = 0;
+    size_t materialChanges = 0;
+    size_t uniformUploads = 0;   // glUniform* de grupo/objeto (posScale, model, ...)
+    size_t instanceUploads = 0;  // envios de matrizes para o VBO de instncias
+};
+
+// Contexto com glMultiDrawElementsIndirect e SSBOs (GL 4.3)?
+bool indirectDrawSupported();
+
+// Incio do frame: esvazia a fila. `view` d a profundidade dos pacotes.
+void beginRenderQueue(const glm::mat4& view);
+
+// Um grupo com a prpria matriz model. `model` precisa viver at o flush.
+void submitGroup(const ShaderProgram& program, const Group* g, int lod, const glm::mat4* model,
+                 RenderPass pass = PASS_OPAQUE);
+
+// Um grupo desenhado `count` vezes, com as matrizes de `models` no VBO de
+// instncias da malha (enviadas no flush). `models` precisa viver at l.
+void submitInstanced(const ShaderProgram& program, Mesh* mesh, const Group* g, int lod,
+                     const glm::mat4* models, int count, RenderPass pass = PASS_OPAQUE);
+
+// Thread do GL: ordena e desenha a fila. Deixa o VAO desligado.
+void flushRenderQueue();
+
+// Contagens do ltimo flush.
+RenderQueueStats renderQueueStats();
+void printRenderQueueStats();
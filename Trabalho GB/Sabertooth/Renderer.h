@@ -1,5 +0,0 @@
-#pragma once
-#include "Obj3D.h"
-#include <GL/glew.h>
-
-void drawObject(Obj3D* obj, GLuint shaderProgram);
\ No newline at end of file
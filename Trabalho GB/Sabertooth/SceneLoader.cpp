@@ -1,5 +1,5 @@
 #include "SceneLoader.h"
-#include "OBJLoader.h"
+#include "AssetCache.h"
 
 #include <fstream>
 #include <sstream>
@@ -8,6 +8,17 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+// Objeto novo cuja malha (compartilhada pelo cache de assets)  carregada
+// em segundo plano; at l obj->mesh fica nullptr e o objeto no  desenhado.
+// Entradas da cena nascem estticas; quem anima um objeto desmarca isStatic.
+static Obj3D* loadModel(const std::string& path)
+{
+    Obj3D* obj = new Obj3D();
+    obj->isStatic = true;
+    requestMesh(path, obj);
+    return obj;
+}
+
 Scene* loadScene(const std::string& path)
 {
     std::ifstream file(path);
@@ -37,11 +48,7 @@ Scene* loadScene(const std::string& path)
 
             ss >> modelPath >> px >> py >> pz >> sx >> sy >> sz >> rx >> ry >> rz;
 
-            Obj3D* obj = loadOBJ(modelPath);
-            if (!obj) {
-                std::cerr << "Falha ao carregar modelo: " << modelPath << std::endl;
-                continue;
-            }
+            Obj3D* obj = loadModel(modelPath);
 
             glm::mat4 transform = glm::mat4(1.0f);
             transform = glm::translate(transform, glm::vec3(px, py, pz));
@@ -59,11 +66,7 @@ Scene* loadScene(const std::string& path)
             std::string modelPath;
             ss >> modelPath;
 
-            Obj3D* obj = loadOBJ(modelPath);
-            if (!obj) {
-                std::cerr << "Falha ao carregar OBJ: " << modelPath << std::endl;
-                continue;
-            }
+            Obj3D* obj = loadModel(modelPath);
 
             obj->transform = glm::mat4(1.0f); 
             scene->objects.push_back(obj);
@@ -78,11 +81,7 @@ Scene* loadScene(const std::string& path)
 
             ss >> modelPath >> px >> py >> pz >> scale >> rx >> ry >> rz;
 
-            Obj3D* obj = loadOBJ(modelPath);
-            if (!obj) {
-                std::cerr << "Falha ao carregar track: " << modelPath << std::endl;
-                continue;
-            }
+            Obj3D* obj = loadModel(modelPath);
 
             glm::mat4 transform = glm::mat4(1.0f);
             transform = glm::translate(transform, glm::vec3(px, py, pz));
@@ -110,9 +109,20 @@ Scene* loadScene(const std::string& path)
         }
     }
 
-    std::cout << "Cena carregada com "
+    std::cout << "Cena lida com "
         << scene->objects.size() << " objetos e "
-        << scene->lights.size() << " luz(es).\n";
+        << scene->lights.size() << " luz(es); malhas carregando em segundo plano.\n";
 
     return scene;
-}
\ No newline at end of file
+}
+
+void releaseScene(Scene* scene)
+{
+    if (!scene) return;
+
+    for (Obj3D* obj : scene->objects) {
+        releaseMesh(obj);
+        delete obj;
+    }
+    delete scene;
+}
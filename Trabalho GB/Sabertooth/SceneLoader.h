@@ -3,3 +3,6 @@
 #include "Scene.h"
 
 Scene* loadScene(const std::string& path);
+
+// Devolve as malhas dos objetos ao cache de assets e apaga a cena.
+void releaseScene(Scene* scene);
@@ -0,0 +1,85 @@
+#include "ShaderProgram.h"
+#include <iostream>
+
+// Nome e tipo esperado de cada ShaderUniform
+static const struct {
+    const char* name;
+    GLenum type;
+} knownUniforms[UNIFORM_COUNT] = {
+    { "model",         GL_FLOAT_MAT4 },
+    { "instanced",     GL_BOOL },
+    { "posScale",      GL_FLOAT_VEC3 },
+    { "posBias",       GL_FLOAT_VEC3 },
+    { "materialIndex", GL_INT },
+    { "hasTexCoords",  GL_BOOL },
+    { "texSampler",    GL_SAMPLER_2D },
+    { "textureAtlas",  GL_SAMPLER_2D },
+};
+
+ShaderProgram::ShaderProgram()
+{
+    for (GLint& l : loc) l = -1;
+    for (GLint& l : textureArrays) l = -1;
+}
+
+// Location e tipo conferido de um uniform da tabela
+static GLint resolve(const ShaderProgram& prog, const std::string& name, GLenum type)
+{
+    for (const ActiveUniform& u : prog.active)
+    {
+        if (u.name != name) continue;
+        if (u.type != type)
+            std::cerr << "[Shader] AVISO: uniform " << name << " com tipo inesperado (0x" << std::hex << u.type << std::dec << ")\n";
+        return u.location;
+    }
+    return -1;
+}
+
+void reflectProgram(GLuint program, ShaderProgram& out)
+{
+    out = ShaderProgram();
+    out.id = program;
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> buffer(maxLength + 1);
+
+    for (GLuint i = 0; i < (GLuint)count; i++)
+    {
+        // membros de uniform blocks (materiais, frame, luzes) no tm location
+        GLint block = -1;
+        glGetActiveUniformsiv(program, 1, &i, GL_UNIFORM_BLOCK_INDEX, &block);
+        if (block >= 0) continue;
+
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, i, (GLsizei)buffer.size(), &length, &size, &type, buffer.data());
+        std::string name(buffer.data(), length);
+
+        // arrays de tipos bsicos vm como "nome[0]" com size > 1: uma
+        // entrada por elemento, j que as locations no precisam ser seguidas
+        bool isArray = name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0;
+        std::string base = isArray ? name.substr(0, name.size() - 3) : name;
+
+        for (GLint e = 0; e < size; e++)
+        {
+            std::string element = isArray ? base + "[" + std::to_string(e) + "]" : name;
+            GLint location = glGetUniformLocation(program, element.c_str());
+            if (location >= 0)
+                out.active.push_back({ element, location, type });
+        }
+    }
+
+    for (int u = 0; u < UNIFORM_COUNT; u++)
+        out.loc[u] = resolve(out, knownUniforms[u].name, knownUniforms[u].type);
+
+    for (int i = 0; i < MAX_TEXTURE_ARRAYS; i++)
+        out.textureArrays[i] = resolve(out, "textureArrays[" + std::to_string(i) + "]", GL_SAMPLER_2D_ARRAY);
+
+    out.indirect = glGetAttribLocation(program, "aDrawIndex") >= 0;
+
+    std::cout << "[Shader] Programa " << program << ": " << out.active.size() << " uniforms ativos"
+        << (out.indirect ? " (multi-draw indireto)\n" : "\n");
+}
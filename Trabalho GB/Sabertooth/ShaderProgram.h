@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+// Reflexo de um programa linkado: todos os uniforms ativos resolvidos uma
+// vez (loadShader), numa tabela indexada por ShaderUniform. O loop de
+// desenho usa program.loc[...] direto, sem strings nem glGetUniformLocation.
+// Cmera e luzes no passam por aqui: so blocos (FrameUniforms).
+
+#define MAX_TEXTURE_ARRAYS 4   // igual ao core.frag e TextureArrays.h
+
+// Uniforms conhecidos do core.vert/core.frag. Os que o programa no usa
+// (ou que o compilador eliminou) ficam com location -1, que o glUniform*
+// ignora.
+enum ShaderUniform {
+    UNIFORM_MODEL,
+    UNIFORM_INSTANCED,
+    UNIFORM_POS_SCALE,
+    UNIFORM_POS_BIAS,
+    UNIFORM_MATERIAL_INDEX,
+    UNIFORM_HAS_TEX_COORDS,
+    UNIFORM_TEX_SAMPLER,
+    UNIFORM_TEXTURE_ATLAS,
+    UNIFORM_COUNT
+};
+
+struct ActiveUniform {
+    std::string name;   // elementos de array separados: "textureArrays[2]"
+    GLint location;
+    GLenum type;        // GL_FLOAT_VEC3, GL_SAMPLER_2D, ...
+};
+
+struct ShaderProgram {
+    GLuint id = 0;
+    GLint loc[UNIFORM_COUNT];
+
+    // arrays, por elemento
+    GLint textureArrays[MAX_TEXTURE_ARRAYS];
+
+    // core_indirect.vert (atributo aDrawIndex): dados por draw no bloco
+    // Draws, desenhado pela RenderQueue com multi-draw indireto
+    bool indirect = false;
+
+    // todos os uniforms ativos fora de blocos
+    std::vector<ActiveUniform> active;
+
+    ShaderProgram();
+};
+
+// L os uniforms ativos de um programa j linkado e resolve a tabela.
+// Avisa quando um uniform conhecido tem tipo diferente do esperado.
+void reflectProgram(GLuint program, ShaderProgram& out);
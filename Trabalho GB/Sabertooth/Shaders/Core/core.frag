@@ -1,9 +1,17 @@
 #version 330 core
 in vec3 FragPos;
 in vec3 Normal;
+in vec2 TexCoord;
 out vec4 FragColor;
 
 #define MAX_LIGHTS 8
+#define MAX_MATERIALS 192      // igual a MaterialTable.h
+#define MAX_TEXTURE_ARRAYS 4   // igual a TextureArrays.h
+
+// material.texPage
+#define TEXTURE_STANDALONE -1
+#define TEXTURE_ATLAS -2
+#define TEXTURE_PLACEHOLDER -3
 
 struct Material {
     vec3 ka;
@@ -11,27 +19,108 @@ struct Material {
     vec3 ks;
     float shininess;
     bool  hasTexture;
+    int   texPage;     // array (>= 0), atlas, textura avulsa ou substituta
+    float texLayer;    // camada no array
+    vec4  atlasRect;   // offset.xy, escala.zw no atlas; cor mdia na substituta
+};
+
+// Luzes da cena (FrameUniforms.cpp), layout std140
+struct LightData {
+    vec4 position;   // w = ligada
+    vec4 color;
+};
+
+// Tabela de materiais (MaterialTable.cpp), layout std140
+struct MaterialData {
+    vec4  ka;
+    vec4  kd;
+    vec4  ks;          // w = shininess
+    vec4  atlasRect;
+    ivec4 texInfo;     // hasTexture, texPage, texLayer
 };
 
-struct Light {
-    vec3 position;
-    vec3 color;
+layout(std140) uniform Materials {
+    MaterialData materials[MAX_MATERIALS];
 };
 
-uniform Material material;
-uniform sampler2D texSampler;
+#ifdef INDIRECT_DRAW
+// multi-draw indireto: material e hasTexCoords so por draw (core_indirect.vert)
+flat in int vMaterialIndex;
+flat in int vHasTexCoords;
+#define materialIndex vMaterialIndex
+#define hasTexCoords (vHasTexCoords != 0)
+#else
+uniform int materialIndex;
+uniform bool hasTexCoords;   // grupo sem `vt`: projeo planar em XZ
+#endif
+Material material;   // materials[materialIndex], lido no incio do main
 
-// lights
-uniform int lightCount;
-uniform Light lights[MAX_LIGHTS];
-uniform bool lightEnabled[MAX_LIGHTS];
-uniform bool globalLightEnabled;
-uniform vec3 cameraPos;
+uniform sampler2D texSampler;                              // textura avulsa
+uniform sampler2DArray textureArrays[MAX_TEXTURE_ARRAYS];
+uniform sampler2D textureAtlas;
+
+layout(std140) uniform Frame {
+    mat4 view;
+    mat4 proj;
+    vec4 cameraPos;
+};
+
+layout(std140) uniform Lights {
+    int lightCount;
+    bool globalLightEnabled;
+    LightData lights[MAX_LIGHTS];
+};
+
+// Gradientes vindos de fora: no caminho indireto o material muda dentro do
+// mesmo draw, ento nada aqui roda em fluxo uniforme e dFdx/texture() com
+// mipmap implcito ficariam indefinidos. Tudo usa textureGrad.
+vec4 sampleMaterialTexture(vec2 uv, vec2 uvDx, vec2 uvDy)
+{
+    // textura ainda a caminho: a cor mdia dela, sem amostrar nada
+    if (material.texPage == TEXTURE_PLACEHOLDER)
+        return material.atlasRect;
+
+    if (material.texPage == TEXTURE_ATLAS)
+    {
+        // repetio feita aqui; os gradientes da UV contnua evitam que o
+        // salto do fract() caia num mipmap errado na borda da regio
+        // e presa meio texel para dentro da regio, longe da borda
+        vec2 halfTexel = 0.5 / vec2(textureSize(textureAtlas, 0));
+        vec2 atlasUV = material.atlasRect.xy + fract(uv) * material.atlasRect.zw;
+        atlasUV = clamp(atlasUV, material.atlasRect.xy + halfTexel, material.atlasRect.xy + material.atlasRect.zw - halfTexel);
+        return textureGrad(textureAtlas, atlasUV, uvDx * material.atlasRect.zw, uvDy * material.atlasRect.zw);
+    }
+
+    // GLSL 3.30 s indexa arrays de samplers com constantes
+    vec3 coord = vec3(uv, material.texLayer);
+    if (material.texPage == 0) return textureGrad(textureArrays[0], coord, uvDx, uvDy);
+    if (material.texPage == 1) return textureGrad(textureArrays[1], coord, uvDx, uvDy);
+    if (material.texPage == 2) return textureGrad(textureArrays[2], coord, uvDx, uvDy);
+    if (material.texPage == 3) return textureGrad(textureArrays[3], coord, uvDx, uvDy);
+    return textureGrad(texSampler, uv, uvDx, uvDy);
+}
+
+Material loadMaterial(int index)
+{
+    MaterialData d = materials[index];
+    Material m;
+    m.ka = d.ka.rgb;
+    m.kd = d.kd.rgb;
+    m.ks = d.ks.rgb;
+    m.shininess = d.ks.w;
+    m.hasTexture = d.texInfo.x != 0;
+    m.texPage = d.texInfo.y;
+    m.texLayer = float(d.texInfo.z);
+    m.atlasRect = d.atlasRect;
+    return m;
+}
 
 void main()
 {
+    material = loadMaterial(materialIndex);
+
     vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(cameraPos - FragPos);
+    vec3 viewDir = normalize(cameraPos.xyz - FragPos);
     vec3 result = vec3(0.0);
     
     if (globalLightEnabled)
@@ -43,25 +132,27 @@ void main()
         int count = clamp(lightCount, 0, MAX_LIGHTS);
         for (int i = 0; i < count; ++i)
         {
-            if (!lightEnabled[i]) continue;
+            LightData L = lights[i];
+            if (L.position.w == 0.0) continue;
             
-            Light L = lights[i];
-            vec3 lightDir = normalize(L.position - FragPos);
+            vec3 lightPos = L.position.xyz;
+            vec3 lightColor = L.color.rgb;
+            vec3 lightDir = normalize(lightPos - FragPos);
             
             // ambient: usa Kd com fator baixo ao invs de Ka
-            vec3 ambient = material.kd * (0.05 * L.color);
+            vec3 ambient = material.kd * (0.05 * lightColor);
             
             // diffuse
             float diff = max(dot(norm, lightDir), 0.0);
-            vec3 diffuse = material.kd * diff * L.color;
+            vec3 diffuse = material.kd * diff * lightColor;
             
             // specular (Phong)
             vec3 reflectDir = reflect(-lightDir, norm);
             float spec = pow(max(dot(viewDir, reflectDir), 0.0), max(material.shininess, 1.0));
-            vec3 specular = material.ks * spec * L.color;
+            vec3 specular = material.ks * spec * lightColor;
             
             // attenuation - ajustado para no atenuar tanto de perto
-            float distance = length(L.position - FragPos);
+            float distance = length(lightPos - FragPos);
             float attenuation = 1.0 / (1.0 + 0.045 * distance + 0.0075 * distance * distance);
             
             result += (ambient + diffuse + specular) * attenuation;
@@ -74,10 +165,14 @@ void main()
         result = material.kd * 0.5;
     }
 
+    // derivadas fora de qualquer if (fluxo uniforme)
+    vec2 uv = hasTexCoords ? TexCoord : vec2(FragPos.x, FragPos.z);
+    vec2 uvDx = dFdx(uv);
+    vec2 uvDy = dFdy(uv);
+
     if (material.hasTexture)
     {
-        vec2 uv = vec2(FragPos.x, FragPos.z);
-        vec4 texColor = texture(texSampler, uv);
+        vec4 texColor = sampleMaterialTexture(uv, uvDx, uvDy);
         result *= texColor.rgb;
     }
     
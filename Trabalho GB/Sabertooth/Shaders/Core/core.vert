@@ -1,19 +1,45 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
+layout (location = 0) in vec3 aPos;        // snorm16 nos bounds do grupo ou float
+layout (location = 1) in vec2 aNormal;     // normal octadrica (snorm16)
+layout (location = 2) in vec2 aTexCoord;   // half float
+layout (location = 3) in mat4 aModel;      // por instncia (3..6)
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 proj;
+uniform bool instanced;   // true: matriz model vem do VBO de instncias
+
+// Cmera do frame (FrameUniforms.cpp), layout std140
+layout(std140) uniform Frame {
+    mat4 view;
+    mat4 proj;
+    vec4 cameraPos;
+};
+
+// desfaz a quantizao da posio (identidade para posies em float)
+uniform vec3 posScale = vec3(1.0);
+uniform vec3 posBias = vec3(0.0);
 
 out vec3 FragPos;
 out vec3 Normal;
+out vec2 TexCoord;
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal  = mat3(transpose(inverse(model))) * aNormal;
+    vec3 pos = aPos * posScale + posBias;
+
+    mat4 M = instanced ? aModel : model;
+
+    FragPos = vec3(M * vec4(pos, 1.0));
+    Normal  = mat3(transpose(inverse(M))) * octDecode(aNormal);
+    TexCoord = aTexCoord;
 
     gl_Position = proj * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+}
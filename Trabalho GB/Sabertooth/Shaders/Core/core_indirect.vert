@@ -0,0 +1,60 @@
+#version 430 core
+
+// Caminho do multi-draw indireto (RenderQueue, GL 4.3+). Um draw cobre
+// grupos e objetos diferentes, ento o que no core.vert  uniform vem de um
+// registro por instncia no bloco Draws. O ndice do registro chega por um
+// atributo com divisor 1 ligado a 0, 1, 2, ...: a instncia i de um comando
+// l o registro baseInstance + i.
+// O core.frag  o mesmo, compilado com INDIRECT_DRAW.
+
+layout (location = 0) in vec3 aPos;        // snorm16 nos bounds do grupo ou float
+layout (location = 1) in vec2 aNormal;     // normal octadrica (snorm16)
+layout (location = 2) in vec2 aTexCoord;   // half float
+layout (location = 7) in uint aDrawIndex;  // registro em Draws
+
+layout(std140) uniform Frame {
+    mat4 view;
+    mat4 proj;
+    vec4 cameraPos;
+};
+
+// Igual a DrawData do RenderQueue.cpp, layout std430
+struct DrawData {
+    mat4 model;
+    vec4 posScale;   // desfaz a quantizao da posio
+    vec4 posBias;
+    ivec4 info;      // ndice do material, hasTexCoords
+};
+
+layout(std430, binding = 3) readonly buffer Draws {
+    DrawData draws[];
+};
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+flat out int vMaterialIndex;
+flat out int vHasTexCoords;
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+void main()
+{
+    DrawData d = draws[aDrawIndex];
+
+    vec3 pos = aPos * d.posScale.xyz + d.posBias.xyz;
+
+    FragPos = vec3(d.model * vec4(pos, 1.0));
+    Normal  = mat3(transpose(inverse(d.model))) * octDecode(aNormal);
+    TexCoord = aTexCoord;
+    vMaterialIndex = d.info.x;
+    vHasTexCoords = d.info.y;
+
+    gl_Position = proj * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,263 @@
+#include "StaticBatch.h"
+
+#include <map>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <GL/glew.h>
+
+// Pginas so Groups donos de VAO/VBO/EBO (Group::upload); as faixas s
+// apontam para o VAO da pgina e no apagam nada.
+static std::vector<Group*> pages;
+static std::vector<Group*> draws;
+static StaticBatchStats stats;
+static const glm::mat4 identity(1.0f);
+
+struct StaticSource {
+    const Obj3D* obj;
+    const Group* group;
+};
+
+// Pgina em montagem
+struct PageBuilder {
+    std::vector<PackedVertexF> vertices;
+    std::vector<uint32_t> indices;
+    size_t firstDraw = 0;   // primeira faixa desta pgina em `draws`
+};
+
+// Vrtices e ndices do grupo na memria: a cpia do grupo quando existe,
+// seno lidos de volta dos buffers (GL_COPY_READ_BUFFER no mexe em VAO).
+static const unsigned char* readVertices(const Group* g, std::vector<unsigned char>& scratch)
+{
+    size_t bytes = (size_t)g->numVertices * g->vertexStride;
+    if (g->vertexData.size() >= bytes) return g->vertexData.data();
+
+    scratch.resize(bytes);
+    glBindBuffer(GL_COPY_READ_BUFFER, g->VBO);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, bytes, scratch.data());
+    return scratch.data();
+}
+
+static void readIndices(const Group* g, uint32_t first, uint32_t count, std::vector<uint32_t>& out)
+{
+    out.resize(count);
+    if (g->indices.size() >= (size_t)first + count) {
+        std::copy(g->indices.begin() + first, g->indices.begin() + first + count, out.begin());
+        return;
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, g->EBO);
+    if (g->indexType == GL_UNSIGNED_SHORT) {
+        std::vector<uint16_t> shorts(count);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, first * sizeof(uint16_t), count * sizeof(uint16_t), shorts.data());
+        std::copy(shorts.begin(), shorts.end(), out.begin());
+    }
+    else {
+        glGetBufferSubData(GL_COPY_READ_BUFFER, first * sizeof(uint32_t), count * sizeof(uint32_t), out.data());
+    }
+}
+
+// Leva o grupo para o mundo e o acrescenta  pgina; estende a faixa atual.
+static void appendGroup(PageBuilder& page, Group* draw, const StaticSource& src)
+{
+    const Group* g = src.group;
+    const glm::mat4& m = src.obj->transform;
+    glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(m)));
+
+    std::vector<unsigned char> scratch;
+    const unsigned char* data = readVertices(g, scratch);
+
+    uint32_t base = (uint32_t)page.vertices.size();
+    page.vertices.resize(base + g->numVertices);
+
+    for (int i = 0; i < g->numVertices; i++)
+    {
+        const unsigned char* v = data + (size_t)i * g->vertexStride;
+        glm::vec3 p;
+        const int16_t* normal;
+        const uint16_t* uv;
+        if (g->quantizedPositions) {
+            const PackedVertex* q = (const PackedVertex*)v;
+            p = glm::vec3(fromSnorm16(q->position[0]), fromSnorm16(q->position[1]), fromSnorm16(q->position[2]))
+                * g->posScale + g->posBias;
+            normal = q->normal;
+            uv = q->uv;
+        }
+        else {
+            const PackedVertexF* f = (const PackedVertexF*)v;
+            p = glm::vec3(f->position[0], f->position[1], f->position[2]);
+            normal = f->normal;
+            uv = f->uv;
+        }
+
+        glm::vec3 w = glm::vec3(m * glm::vec4(p, 1.0f));
+        glm::vec3 n = normalMatrix * octDecode(glm::vec2(fromSnorm16(normal[0]), fromSnorm16(normal[1])));
+        glm::vec2 oct = octEncode(glm::normalize(n));
+
+        PackedVertexF& out = page.vertices[base + i];
+        out.position[0] = w.x;
+        out.position[1] = w.y;
+        out.position[2] = w.z;
+        out.normal[0] = toSnorm16(oct.x);
+        out.normal[1] = toSnorm16(oct.y);
+        std::memcpy(out.uv, uv, sizeof(out.uv));
+
+        bool first = draw->lods[0].indexCount == 0 && i == 0;
+        draw->boundsMin = first ? w : glm::min(draw->boundsMin, w);
+        draw->boundsMax = first ? w : glm::max(draw->boundsMax, w);
+    }
+
+    // s o nvel completo
+    uint32_t firstIndex = g->lods.empty() ? 0 : g->lods[0].firstIndex;
+    uint32_t indexCount = (uint32_t)g->lodIndexCount(0);
+    std::vector<uint32_t> indices;
+    readIndices(g, firstIndex, indexCount, indices);
+
+    // transformao espelhada inverte a ordem dos cantos
+    bool mirrored = glm::determinant(glm::mat3(m)) < 0.0f;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        page.indices.push_back(base + indices[t]);
+        page.indices.push_back(base + indices[t + (mirrored ? 2 : 1)]);
+        page.indices.push_back(base + indices[t + (mirrored ? 1 : 2)]);
+    }
+    draw->lods[0].indexCount += indexCount;
+}
+
+// Envia a pgina e liga as faixas dela ao VAO
+static void flushPage(PageBuilder& page)
+{
+    if (page.vertices.empty()) return;
+
+    Group* p = new Group();
+    p->name = "static page";
+    p->quantizedPositions = false;
+    p->vertexStride = sizeof(PackedVertexF);
+
+    size_t indexBytes;
+    if (page.vertices.size() <= 0xFFFF) {
+        std::vector<uint16_t> shorts(page.indices.begin(), page.indices.end());
+        p->upload(page.vertices.data(), (int)page.vertices.size(), shorts.data(), (int)shorts.size(), GL_UNSIGNED_SHORT);
+        indexBytes = shorts.size() * sizeof(uint16_t);
+    }
+    else {
+        p->upload(page.vertices.data(), (int)page.vertices.size(), page.indices.data(), (int)page.indices.size(), GL_UNSIGNED_INT);
+        indexBytes = page.indices.size() * sizeof(uint32_t);
+    }
+    pages.push_back(p);
+
+    for (size_t d = page.firstDraw; d < draws.size(); d++) {
+        draws[d]->VAO = p->VAO;
+        draws[d]->indexType = p->indexType;
+    }
+
+    stats.pages++;
+    stats.vertices += page.vertices.size();
+    stats.indices += page.indices.size();
+    stats.bytes += page.vertices.size() * sizeof(PackedVertexF) + indexBytes;
+
+    page.vertices.clear();
+    page.indices.clear();
+    page.firstDraw = draws.size();
+}
+
+static Group* beginDraw(const PageBuilder& page, Material* material, bool hasTexCoords)
+{
+    Group* d = new Group();
+    d->name = material ? material->name : "static";
+    d->material = material;
+    d->hasTexCoords = hasTexCoords;
+    d->quantizedPositions = false;
+    d->vertexStride = sizeof(PackedVertexF);
+    d->lods.push_back({ (uint32_t)page.indices.size(), 0, 0.0f });
+    draws.push_back(d);
+    return d;
+}
+
+void buildStaticBatch(const std::vector<Obj3D*>& objects)
+{
+    // faixas por (material, tem UV): o uniform hasTexCoords vale para a faixa toda
+    std::map<std::pair<Material*, bool>, std::vector<StaticSource>> byMaterial;
+    size_t objectCount = 0, groupCount = 0;
+
+    for (Obj3D* obj : objects)
+    {
+        if (!obj || !obj->isStatic || obj->staticBatched || !obj->mesh) continue;
+
+        // tudo ou nada: com um grupo de fora (sem buffers), o objeto segue
+        // no caminho normal, que desenharia os juntados de novo
+        bool complete = true;
+        for (const Group* g : obj->mesh->groups)
+            if (g->lodIndexCount(0) > 0 && !g->VAO) complete = false;
+        if (!complete) continue;
+
+        for (const Group* g : obj->mesh->groups) {
+            if (g->lodIndexCount(0) == 0) continue;
+            byMaterial[{ g->material, g->hasTexCoords }].push_back({ obj, g });
+            groupCount++;
+        }
+        obj->staticBatched = true;
+        objectCount++;
+    }
+    if (byMaterial.empty()) return;
+
+    PageBuilder page;
+    page.firstDraw = draws.size();
+
+    for (auto& kv : byMaterial)
+    {
+        Group* draw = nullptr;
+        for (const StaticSource& src : kv.second)
+        {
+            // grupo maior que uma pgina vai sozinho numa pgina prpria
+            if (!page.vertices.empty() && page.vertices.size() + src.group->numVertices > STATIC_PAGE_VERTICES) {
+                flushPage(page);
+                draw = nullptr;
+            }
+            if (!draw) draw = beginDraw(page, kv.first.first, kv.first.second);
+            appendGroup(page, draw, src);
+        }
+    }
+    flushPage(page);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    stats.objects += objectCount;
+    stats.sourceGroups += groupCount;
+    stats.draws = draws.size();
+    printStaticBatchStats();
+}
+
+const std::vector<Group*>& staticDraws()
+{
+    return draws;
+}
+
+const glm::mat4* staticModel()
+{
+    return &identity;
+}
+
+void releaseStaticBatch()
+{
+    for (Group* d : draws) {
+        d->VAO = 0;   // da pgina
+        delete d;
+    }
+    for (Group* p : pages) delete p;
+    draws.clear();
+    pages.clear();
+    stats = StaticBatchStats();
+}
+
+StaticBatchStats staticBatchStats()
+{
+    return stats;
+}
+
+void printStaticBatchStats()
+{
+    const StaticBatchStats& s = stats;
+    std::cout << "[Static] " << s.objects << " objetos estticos, " << s.sourceGroups << " grupos -> "
+        << s.draws << " draws em " << s.pages << " pgina(s) (" << s.vertices << " vrtices, "
+        << s.indices / 3 << " tringulos, " << s.bytes / 1024 << " KB)\n";
+}
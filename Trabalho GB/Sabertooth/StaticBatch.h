@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include "Obj3D.h"
+
+// Geometria esttica (pista, modelos parados) juntada numa etapa de
+// montagem da cena: os vrtices de cada objeto isStatic vo para o espao
+// de mundo e so concatenados por material em pginas de VBO/EBO
+// compartilhadas. Cada faixa de um material numa pgina vira um Group com
+// o VAO da pgina, desenhado pela RenderQueue com a matriz identidade: um
+// draw por material e pgina, em vez de um por grupo de cada objeto.
+// Objetos que se movem (o carro, projteis) continuam no caminho normal.
+
+#define STATIC_PAGE_VERTICES (256 * 1024)   // por pgina (PackedVertexF: 5 MB)
+
+struct StaticBatchStats {
+    size_t objects = 0;        // objetos juntados
+    size_t sourceGroups = 0;   // grupos de origem (um draw cada, sem as pginas)
+    size_t draws = 0;          // faixas nas pginas
+    size_t pages = 0;
+    size_t vertices = 0;
+    size_t indices = 0;
+    size_t bytes = 0;          // VRAM das pginas
+};
+
+// Thread do GL: junta nas pginas os objetos isStatic com malha residente
+// que ainda no esto nelas e marca staticBatched; objeto com algum grupo
+// sem buffers fica de fora inteiro. S o nvel de detalhe completo entra.
+// Os vrtices vm da cpia do grupo na memria ou, para malhas do cache
+// binrio (enviadas direto do arquivo), lidos de volta da GPU. Feito uma
+// vez, quando as malhas da cena terminam de carregar.
+void buildStaticBatch(const std::vector<Obj3D*>& objects);
+
+// Faixas prontas, j em coordenadas de mundo (boundsMin/Max inclusive).
+const std::vector<Group*>& staticDraws();
+
+// Matriz model das faixas (identidade); vive at o fim do programa.
+const glm::mat4* staticModel();
+
+void releaseStaticBatch();
+
+StaticBatchStats staticBatchStats();
+void printStaticBatchStats();
@@ -0,0 +1,328 @@
+#include "TextureArrays.h"
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+
+// Unidades fixas: 0 para a textura avulsa do material, depois os arrays,
+// depois o atlas
+static const int ARRAY_UNIT = 1;
+static const int ATLAS_UNIT = ARRAY_UNIT + MAX_TEXTURE_ARRAYS;
+
+// Memria reservada por array: define quantas camadas ele comporta
+static const size_t ARRAY_PAGE_BYTES = 64u << 20;
+static const int ARRAY_MAX_LAYERS = 16;
+
+static const int ATLAS_ALIGN = 1 << (ATLAS_LEVELS - 1);
+static const int ATLAS_GUTTER = ATLAS_ALIGN;   // 1 texel no nvel mais baixo
+
+struct ArrayPage {
+    GLuint id = 0;
+    GLenum format = 0;
+    int width = 0;
+    int height = 0;
+    int levels = 0;
+    size_t bytes = 0;
+    std::vector<bool> used;   // vazio: pgina apagada, ndice livre para outra
+};
+
+// Prateleira do atlas: faixa horizontal preenchida da esquerda para a direita
+struct AtlasShelf {
+    int y;
+    int height;
+    int x;
+};
+
+static std::vector<ArrayPage> arrays;
+static GLuint atlas = 0;
+static std::vector<AtlasShelf> shelves;
+static int atlasTextures = 0;   // regies vivas; sem nenhuma o atlas recomea vazio
+static size_t atlasBytes = 0;
+
+static bool isPowerOfTwo(int v) { return v > 0 && (v & (v - 1)) == 0; }
+
+static int roundUp(int v, int a) { return (v + a - 1) / a * a; }
+
+bool wantsAtlas(int width, int height)
+{
+    return !(isPowerOfTwo(width) && isPowerOfTwo(height)) &&
+        width <= ATLAS_SIZE / 4 && height <= ATLAS_SIZE / 4;
+}
+
+static void setSampling(GLenum target, int levels)
+{
+    glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+static const void* levelData(const unsigned char* base, const TextureLevel& lv)
+{
+    return (const void*)((uintptr_t)base + lv.offset);
+}
+
+// ---------------------------------------------------------------------------
+// Arrays
+// ---------------------------------------------------------------------------
+
+static bool createArrayPage(const DDSImage& dds, ArrayPage& page)
+{
+    size_t texBytes = dds.size();
+    int layers = (int)std::max<size_t>(1, std::min<size_t>(ARRAY_MAX_LAYERS, ARRAY_PAGE_BYTES / texBytes));
+
+    page.format = dds.format;
+    page.width = dds.levels[0].width;
+    page.height = dds.levels[0].height;
+    page.levels = (int)dds.levels.size();
+    page.used.assign(layers, false);
+    page.bytes = texBytes * layers;
+
+    // sem dados: com um PBO ligado (envio da recarga) o nullptr viraria offset
+    GLint unpack = 0;
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpack);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    glGenTextures(1, &page.id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, page.id);
+    for (int l = 0; l < page.levels; l++)
+    {
+        const TextureLevel& lv = dds.levels[l];
+        if (dds.compressed())
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, l, dds.format, lv.width, lv.height, layers, 0,
+                (GLsizei)(lv.size * layers), nullptr);
+        else
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, l, dds.format == GL_RGBA ? GL_RGBA8 : GL_RGB8,
+                lv.width, lv.height, layers, 0, dds.format, GL_UNSIGNED_BYTE, nullptr);
+    }
+    setSampling(GL_TEXTURE_2D_ARRAY, page.levels);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpack);
+
+    std::cout << "[Texturas] Array " << page.width << "x" << page.height << " com "
+        << layers << " camadas\n";
+    return true;
+}
+
+static bool placeInArray(Texture* tex, const unsigned char* base, bool newPages)
+{
+    const DDSImage& dds = tex->dds;
+
+    ArrayPage* page = nullptr;
+    int layer = -1;
+    for (ArrayPage& p : arrays)
+    {
+        if (p.used.empty() || p.format != dds.format || p.width != dds.levels[0].width ||
+            p.height != dds.levels[0].height || p.levels != (int)dds.levels.size())
+            continue;
+        auto it = std::find(p.used.begin(), p.used.end(), false);
+        if (it == p.used.end()) continue;
+        page = &p;
+        layer = (int)(it - p.used.begin());
+        break;
+    }
+
+    if (!page)
+    {
+        if (!newPages) return false;
+
+        // ndice de uma pgina apagada, ou um novo
+        for (ArrayPage& p : arrays)
+            if (p.used.empty()) { page = &p; break; }
+        if (!page) {
+            if (arrays.size() >= MAX_TEXTURE_ARRAYS) return false;
+            arrays.emplace_back();
+            page = &arrays.back();
+        }
+        createArrayPage(dds, *page);
+        layer = 0;
+    }
+
+    page->used[layer] = true;
+    glBindTexture(GL_TEXTURE_2D_ARRAY, page->id);
+    for (size_t l = 0; l < dds.levels.size(); l++)
+    {
+        const TextureLevel& lv = dds.levels[l];
+        if (dds.compressed())
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)l, 0, 0, layer, lv.width, lv.height, 1,
+                dds.format, (GLsizei)lv.size, levelData(base, lv));
+        else
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)l, 0, 0, layer, lv.width, lv.height, 1,
+                dds.format, GL_UNSIGNED_BYTE, levelData(base, lv));
+    }
+
+    tex->page = (int)(page - arrays.data());
+    tex->layer = layer;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Atlas
+// ---------------------------------------------------------------------------
+
+// Reserva um retngulo (alinhado para os mipmaps do atlas carem em texels
+// inteiros) na prateleira mais baixa que comporta a altura. Em volta da
+// imagem fica uma borda de ATLAS_GUTTER texels, que some s no ltimo nvel.
+static bool allocateAtlasRect(int width, int height, int& x, int& y)
+{
+    int w = roundUp(width + 2 * ATLAS_GUTTER, ATLAS_ALIGN);
+    int h = roundUp(height + 2 * ATLAS_GUTTER, ATLAS_ALIGN);
+
+    AtlasShelf* best = nullptr;
+    for (AtlasShelf& s : shelves)
+        if (s.height >= h && s.x + w <= ATLAS_SIZE && (!best || s.height < best->height))
+            best = &s;
+
+    if (!best)
+    {
+        int top = shelves.empty() ? 0 : shelves.back().y + shelves.back().height;
+        if (top + h > ATLAS_SIZE || w > ATLAS_SIZE) return false;
+        shelves.push_back({ top, h, 0 });
+        best = &shelves.back();
+    }
+
+    x = best->x;
+    y = best->y;
+    best->x += w;
+    return true;
+}
+
+static bool placeInAtlas(Texture* tex, bool newPages)
+{
+    const DDSImage& dds = tex->dds;
+
+    if (!atlas)
+    {
+        if (!newPages) return false;
+
+        GLint unpack = 0;   // como em createArrayPage
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpack);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        glGenTextures(1, &atlas);
+        glBindTexture(GL_TEXTURE_2D, atlas);
+        for (int l = 0; l < ATLAS_LEVELS; l++)
+            glTexImage2D(GL_TEXTURE_2D, l, GL_RGBA8, ATLAS_SIZE >> l, ATLAS_SIZE >> l, 0,
+                GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        setSampling(GL_TEXTURE_2D, ATLAS_LEVELS);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpack);
+
+        for (int l = 0; l < ATLAS_LEVELS; l++)
+            atlasBytes += (size_t)(ATLAS_SIZE >> l) * (ATLAS_SIZE >> l) * 4;
+    }
+
+    int x, y;
+    if (!allocateAtlasRect(dds.levels[0].width, dds.levels[0].height, x, y))
+        return false;
+
+    // a borda repete os texels da beira, montada na CPU: sai da cpia em
+    // tex->dds mesmo quando os nveis vieram por PBO
+    GLint unpack = 0;
+    glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpack);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    std::vector<uint32_t> padded;
+    for (size_t l = 0; l < dds.levels.size() && l < ATLAS_LEVELS; l++)
+    {
+        const TextureLevel& lv = dds.levels[l];
+        const uint32_t* src = (const uint32_t*)levelData(dds.data(), lv);
+        int g = ATLAS_GUTTER >> l;
+        int pw = lv.width + 2 * g;
+        int ph = lv.height + 2 * g;
+
+        padded.resize((size_t)pw * ph);
+        for (int py = 0; py < ph; py++)
+        {
+            int sy = std::min(std::max(py - g, 0), lv.height - 1);
+            for (int px = 0; px < pw; px++)
+            {
+                int sx = std::min(std::max(px - g, 0), lv.width - 1);
+                padded[(size_t)py * pw + px] = src[(size_t)sy * lv.width + sx];
+            }
+        }
+        glTexSubImage2D(GL_TEXTURE_2D, (GLint)l, x >> l, y >> l, pw, ph,
+            GL_RGBA, GL_UNSIGNED_BYTE, padded.data());
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpack);
+
+    atlasTextures++;
+    tex->page = TEXTURE_ATLAS;
+    tex->atlasRect = glm::vec4(x + ATLAS_GUTTER, y + ATLAS_GUTTER, dds.levels[0].width, dds.levels[0].height)
+        / (float)ATLAS_SIZE;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+bool placeTexture(Texture* tex, const unsigned char* base, bool newPages)
+{
+    if (tex->dds.empty()) return false;
+
+    if (tex->dds.format == GL_RGBA && wantsAtlas(tex->dds.levels[0].width, tex->dds.levels[0].height))
+        return placeInAtlas(tex, newPages);
+    return placeInArray(tex, base, newPages);
+}
+
+void releasePlacement(Texture* tex)
+{
+    if (tex->page >= 0 && tex->page < (int)arrays.size())
+    {
+        ArrayPage& page = arrays[tex->page];
+        page.used[tex->layer] = false;
+        if (std::find(page.used.begin(), page.used.end(), true) == page.used.end()) {
+            glDeleteTextures(1, &page.id);
+            page = ArrayPage();
+        }
+    }
+    else if (tex->page == TEXTURE_ATLAS)
+    {
+        // o empacotamento em prateleiras no reaproveita buracos: o espao
+        // (e a memria) volta quando o atlas esvazia
+        if (--atlasTextures == 0) {
+            shelves.clear();
+            glDeleteTextures(1, &atlas);
+            atlas = 0;
+            atlasBytes = 0;
+        }
+    }
+    tex->page = TEXTURE_STANDALONE;
+}
+
+size_t texturePagesBytes()
+{
+    size_t total = atlasBytes;
+    for (const ArrayPage& p : arrays) total += p.bytes;
+    return total;
+}
+
+void bindTextureUnits(const ShaderProgram& program)
+{
+    // todos os samplers em unidades distintas, mesmo sem array criado:
+    // tipos diferentes na mesma unidade invalidam o draw
+    for (int i = 0; i < MAX_TEXTURE_ARRAYS; i++)
+        glUniform1i(program.textureArrays[i], ARRAY_UNIT + i);
+    glUniform1i(program.loc[UNIFORM_TEXTURE_ATLAS], ATLAS_UNIT);
+    glUniform1i(program.loc[UNIFORM_TEX_SAMPLER], 0);
+}
+
+void bindTexturePages()
+{
+    for (int i = 0; i < MAX_TEXTURE_ARRAYS; i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + ARRAY_UNIT + i);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, i < (int)arrays.size() ? arrays[i].id : 0);
+    }
+
+    glActiveTexture(GL_TEXTURE0 + ATLAS_UNIT);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+
+    glActiveTexture(GL_TEXTURE0);
+}
+
+GLuint standaloneTexture(const Texture* tex)
+{
+    return (tex && tex->resident && tex->page == TEXTURE_STANDALONE) ? tex->id : 0;
+}
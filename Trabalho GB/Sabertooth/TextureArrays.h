@@ -0,0 +1,43 @@
+#pragma once
+#include <GL/glew.h>
+#include "TextureCache.h"
+#include "ShaderProgram.h"
+
+// Texturas agrupadas para que o loop de desenho no troque de textura:
+// as de mesmo tamanho/formato viram camadas de um GL_TEXTURE_2D_ARRAY, e as
+// de tamanho fora do padro (no potncia de 2) so empacotadas num atlas
+// RGBA. Arrays e atlas ficam ligados em unidades fixas durante o frame; o
+// material (MaterialTable) s informa a pgina, a camada e o retngulo.
+
+#define ATLAS_SIZE 2048
+#define ATLAS_LEVELS 6         // nveis do atlas; regies alinhadas a 2^(ATLAS_LEVELS-1)
+
+// A textura deve ir para o atlas? (decidido antes do bake: o atlas  RGBA
+// sem compresso)
+bool wantsAtlas(int width, int height);
+
+// Thread do GL: envia os nveis de tex->dds (a partir de `base`, ponteiro ou
+// offset no PBO ligado) para uma camada de array ou regio do atlas e
+// preenche page/layer/atlasRect. O atlas l sempre tex->dds, para montar a
+// borda em volta da regio. Devolve false se no h lugar: a textura
+// fica avulsa. Com `newPages` false s usa arrays e atlas j criados.
+bool placeTexture(Texture* tex, const unsigned char* base, bool newPages = true);
+
+// Libera a camada/regio da textura (thread do GL). Um array sem nenhuma
+// camada em uso  apagado, e o atlas sem nenhuma regio tambm.
+void releasePlacement(Texture* tex);
+
+// VRAM reservada pelos arrays e pelo atlas, usada ou no.
+size_t texturePagesBytes();
+
+// Aponta os samplers do programa para as unidades fixas (estado do
+// programa: uma vez, logo aps o link, com ele em uso).
+void bindTextureUnits(const ShaderProgram& program);
+
+// Liga arrays e atlas nas unidades fixas. Uma vez por frame, antes dos draws.
+void bindTexturePages();
+
+// Textura GL a ligar na unidade 0 para a textura do material: o id dela se
+// for avulsa e residente, seno 0 (pgina, camada e retngulo das outras
+// vm da tabela de materiais).
+GLuint standaloneTexture(const Texture* tex);
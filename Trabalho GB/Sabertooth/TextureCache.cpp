@@ -0,0 +1,512 @@
+#include "TextureCache.h"
+#include "AssetCache.h"
+#include "AsyncLoader.h"
+#include "Parallel.h"
+#include "BinaryMesh.h"
+#include "MappedFile.h"
+#include "TextureArrays.h"
+#include "MaterialTable.h"
+
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <future>
+#include <cstring>
+#include <cstdint>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image_aug.h"
+
+static std::map<std::string, Texture*> textures;
+static std::mutex textureMutex;
+static TextureCacheStats stats;
+static std::atomic<bool> compression(true);
+
+// residncia: frame atual (enforceTextureBudget) e oramento de VRAM
+static uint64_t frame = 0;
+static size_t budget = 0;
+
+// Abaixo disso a textura sai inteira em vez de perder mais um mipmap
+static const int MIN_DEMOTED_SIZE = 64;
+
+// Trabalho mximo de enforceTextureBudget num frame
+static const int MAX_EVICTIONS_PER_FRAME = 8;
+
+void setTextureCompression(bool enabled)
+{
+    compression = enabled;
+}
+
+static void freeUploadData(Texture* tex)
+{
+    tex->dds.clear();
+}
+
+Texture* acquireTexture(const std::string& path)
+{
+    std::string key = canonicalPath(path);
+    std::lock_guard<std::mutex> lock(textureMutex);
+
+    auto it = textures.find(key);
+    if (it != textures.end()) {
+        stats.hits++;
+        it->second->refs++;
+        return it->second;
+    }
+
+    Texture* tex = new Texture();
+    tex->path = key;
+    tex->refs = 1;
+    readDDSAverageColor(key, tex->averageColor);   // sem .dds, branco (= sem textura)
+    textures[key] = tex;
+    stats.textures++;
+    return tex;
+}
+
+void releaseTexture(Texture* tex)
+{
+    if (!tex) return;
+
+    {
+        std::lock_guard<std::mutex> lock(textureMutex);
+        if (--tex->refs > 0) return;
+        textures.erase(tex->path);
+        stats.textures--;
+        stats.residentBytes -= tex->bytes;
+        if (tex->id) stats.standaloneBytes -= tex->bytes;
+    }
+
+    if (tex->id) glDeleteTextures(1, &tex->id);
+    releasePlacement(tex);
+    if (tex->pbo) glDeleteBuffers(1, &tex->pbo);
+    freeUploadData(tex);
+    delete tex;
+}
+
+// Usa o .dds se ele estiver em dia com a imagem e no formato pedido; seno
+// decodifica a imagem, gera os mipmaps e grava o .dds para as prximas
+// execues.
+static void decodeImage(Texture* tex)
+{
+    MappedFile source;
+    if (!source.open(tex->path)) {
+        std::cerr << "Falha ao carregar textura: " << tex->path << std::endl;
+        tex->failed = true;
+        return;
+    }
+
+    bool compress = compression;
+    uint64_t hash = hashBytes(source.data(), source.size());
+    tex->sourceHash = hash;
+    tex->sourceSize = source.size();
+
+    if (loadDDSCache(tex->path, hash, source.size(), tex->dds))
+    {
+        // as do atlas ficam em RGBA sem compresso
+        bool atlas = wantsAtlas(tex->dds.levels[0].width, tex->dds.levels[0].height);
+        if (atlas ? tex->dds.format == GL_RGBA : tex->dds.compressed() == compress)
+        {
+            tex->width = tex->dds.levels[0].width;
+            tex->height = tex->dds.levels[0].height;
+            tex->channels = (tex->dds.format == GL_RGB || tex->dds.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) ? 3 : 4;
+            std::lock_guard<std::mutex> lock(textureMutex);
+            stats.ddsLoads++;
+            return;
+        }
+        tex->dds.clear();
+    }
+
+    const unsigned char* data = (const unsigned char*)source.data();
+    int size = (int)source.size();
+    unsigned char* pixels = stbi_load_from_memory(data, size, &tex->width, &tex->height, &tex->channels, 0);
+
+    // tons de cinza viram RGB/RGBA; as do atlas, sempre RGBA
+    int wanted = (tex->channels == 2 || tex->channels == 4) ? 4 : 3;
+    if (pixels && wantsAtlas(tex->width, tex->height)) {
+        wanted = 4;
+        compress = false;
+    }
+    if (pixels && tex->channels != wanted) {
+        int channels;
+        stbi_image_free(pixels);
+        tex->channels = wanted;
+        pixels = stbi_load_from_memory(data, size, &tex->width, &tex->height, &channels, wanted);
+    }
+    if (!pixels) {
+        std::cerr << "Falha ao carregar textura: " << tex->path << std::endl;
+        tex->failed = true;
+        return;
+    }
+
+    if (bakeImage(pixels, tex->width, tex->height, tex->channels, compress, tex->dds))
+        writeDDSCache(tex->path, tex->dds, hash, source.size());
+    stbi_image_free(pixels);
+
+    // primeira execuo: a substituta branca ganha a cor mdia j aqui,
+    // antes do upload
+    {
+        std::lock_guard<std::mutex> lock(textureMutex);
+        if (!tex->dds.empty()) tex->averageColor = averageColor(tex->dds);
+        stats.misses++;
+    }
+    invalidateTextureMaterials(tex);
+}
+
+// Uma vez por carga da textura, mesmo com vrios pedidos em paralelo
+static void decode(Texture* tex)
+{
+    std::lock_guard<std::mutex> once(tex->decodeMutex);
+    if (tex->decoded) return;
+    tex->decoded = true;
+    decodeImage(tex);
+}
+
+// Envia os nveis a partir de `base` (ponteiro, ou offset no PBO ligado)
+// para um array/atlas de TextureArrays ou, sem lugar neles, para uma
+// textura prpria. Os mipmaps vm prontos: nada de glGenerateMipmap.
+static void freeGPUStorage(Texture* tex)
+{
+    bool standalone = tex->id != 0;
+    if (tex->id) glDeleteTextures(1, &tex->id);
+    tex->id = 0;
+    releasePlacement(tex);
+
+    std::lock_guard<std::mutex> lock(textureMutex);
+    stats.residentBytes -= tex->bytes;
+    if (standalone) stats.standaloneBytes -= tex->bytes;
+    tex->bytes = 0;
+    tex->resident = false;
+}
+
+static void createTexture(Texture* tex, const unsigned char* base)
+{
+    const DDSImage& dds = tex->dds;
+
+    // recarga (volta dos mipmaps descartados) substitui a anterior
+    if (tex->resident) freeGPUStorage(tex);
+
+    // linhas RGB no so mltiplas de 4 bytes em larguras mpares
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // reduzida pelo oramento: s num array j existente (um novo reservaria
+    // mais do que a reduo liberou); seno avulsa, do tamanho exato
+    if (!placeTexture(tex, base, tex->droppedLevels == 0))
+    {
+        glGenTextures(1, &tex->id);
+        glBindTexture(GL_TEXTURE_2D, tex->id);
+
+        for (size_t l = 0; l < dds.levels.size(); l++)
+        {
+            const TextureLevel& lv = dds.levels[l];
+            const void* data = (const void*)((uintptr_t)base + lv.offset);
+            if (dds.compressed())
+                glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)l, dds.format, lv.width, lv.height, 0, (GLsizei)lv.size, data);
+            else
+                glTexImage2D(GL_TEXTURE_2D, (GLint)l, dds.format, lv.width, lv.height, 0, dds.format, GL_UNSIGNED_BYTE, data);
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)dds.levels.size() - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    {
+        std::lock_guard<std::mutex> lock(textureMutex);
+        tex->resident = true;
+        tex->requested = true;
+        tex->bytes = dds.size();
+        stats.residentBytes += tex->bytes;
+        if (tex->id) stats.standaloneBytes += tex->bytes;
+        tex->averageColor = averageColor(dds);   // para quando sair da GPU
+    }
+
+    // pgina/camada nova para os materiais que usam a textura
+    invalidateTextureMaterials(tex);
+
+    const char* where = tex->page >= 0 ? "array" : (tex->page == TEXTURE_ATLAS ? "atlas" : "avulsa");
+    std::cout << "Textura carregada: " << tex->path << " (" << tex->bytes / 1024 << " KB, " << where << ")" << std::endl;
+}
+
+void streamTextures(const std::vector<Texture*>& list)
+{
+    parallelFor(list.size(), 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; i++) decode(list[i]);
+    });
+
+    // cada textura passa pelo PBO uma vez s, mesmo pedida por vrios .mtl
+    std::vector<Texture*> batch;
+    for (Texture* tex : list)
+        if (!tex->dds.empty() && !tex->staged.exchange(true))
+            batch.push_back(tex);
+    if (batch.empty()) return;
+
+    // mapear exige o contexto: uma tarefa mapeia os PBOs do lote todo
+    std::promise<void> mapped;
+    postGLTask([&batch, &mapped] {
+        for (Texture* tex : batch)
+        {
+            glGenBuffers(1, &tex->pbo);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, tex->pbo);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, tex->dds.size(), nullptr, GL_STREAM_DRAW);
+            tex->staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, tex->dds.size(),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        mapped.set_value();
+    });
+    mapped.get_future().wait();
+
+    // cpia para a memria do driver em paralelo, fora da thread do GL
+    parallelFor(batch.size(), 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; i++)
+        {
+            Texture* tex = batch[i];
+            if (!tex->staging) continue;   // sem PBO: uploadTexture envia direto
+            std::memcpy(tex->staging, tex->dds.data(), tex->dds.size());
+        }
+    });
+
+    for (Texture* tex : batch)
+    {
+        if (!tex->staging) continue;
+
+        postGLTask([tex] {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, tex->pbo);
+            bool ok = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+            tex->staging = nullptr;
+
+            if (ok) createTexture(tex, nullptr);
+            else std::cerr << "Falha no PBO da textura: " << tex->path << std::endl;
+            freeUploadData(tex);
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glDeleteBuffers(1, &tex->pbo);
+            tex->pbo = 0;
+        });
+    }
+}
+
+void uploadTexture(Texture* tex)
+{
+    if (!tex || tex->resident) return;
+
+    decode(tex);
+    if (tex->dds.empty()) return;   // falhou, ou est a caminho via PBO
+    if (tex->staging) return;
+
+    createTexture(tex, tex->dds.data());
+    freeUploadData(tex);
+}
+
+// ---------------------------------------------------------------------------
+// Residncia
+// ---------------------------------------------------------------------------
+
+void setTextureBudget(size_t bytes)
+{
+    budget = bytes;
+}
+
+// VRAM ocupada de fato: arrays e atlas reservados inteiros, mais as avulsas
+static size_t gpuTextureBytes()
+{
+    size_t pages = texturePagesBytes();
+    std::lock_guard<std::mutex> lock(textureMutex);
+    return pages + stats.standaloneBytes;
+}
+
+// Troca a textura pela cadeia sem o mipmap de cima, relida do .dds. S
+// para as que liberam memria ao sair do lugar: avulsas ou a ltima
+// camada de um array.
+static bool demote(Texture* tex)
+{
+    if (tex->page == TEXTURE_ATLAS) return false;   // o atlas no tem mipmaps por regio
+
+    int drop = tex->droppedLevels + 1;
+    if (std::min(tex->width >> drop, tex->height >> drop) < MIN_DEMOTED_SIZE) return false;
+
+    DDSImage full;
+    if (!loadDDSCache(tex->path, tex->sourceHash, tex->sourceSize, full) || (int)full.levels.size() <= drop)
+        return false;
+
+    // nveis a partir de `drop`, com offsets relativos ao novo nvel 0
+    DDSImage lower;
+    lower.format = full.format;
+    lower.file = full.file;
+    lower.fileOffset = full.fileOffset + full.levels[drop].offset;
+    for (size_t l = drop; l < full.levels.size(); l++) {
+        TextureLevel lv = full.levels[l];
+        lv.offset -= full.levels[drop].offset;
+        lower.levels.push_back(lv);
+    }
+
+    tex->dds = lower;
+    tex->droppedLevels = drop;
+    createTexture(tex, tex->dds.data());
+    freeUploadData(tex);
+
+    std::lock_guard<std::mutex> lock(textureMutex);
+    stats.demotions++;
+    return true;
+}
+
+static void evict(Texture* tex)
+{
+    freeGPUStorage(tex);
+    invalidateTextureMaterials(tex);
+    tex->droppedLevels = 0;
+
+    std::lock_guard<std::mutex> lock(textureMutex);
+    stats.evictions++;
+}
+
+// L a cadeia inteira em segundo plano: primeira carga de uma textura
+// visvel ou volta de uma reduzida/removida
+static void reload(Texture* tex)
+{
+    bool restore = tex->requested;
+    tex->requested = true;
+    tex->reloading = true;
+    tex->droppedLevels = 0;   // a cadeia que vai chegar
+    {
+        std::lock_guard<std::mutex> lock(textureMutex);
+        tex->refs++;   // a textura no pode sumir com o job na fila
+    }
+    {
+        std::lock_guard<std::mutex> once(tex->decodeMutex);
+        tex->decoded = false;
+    }
+    tex->staged = false;
+
+    submitLoadJob([tex, restore] {
+        streamTextures({ tex });
+        postGLTask([tex, restore] {
+            // sem PBO os nveis ainda esto em tex->dds
+            if (!tex->dds.empty() && !tex->staging) {
+                createTexture(tex, tex->dds.data());
+                freeUploadData(tex);
+            }
+            tex->reloading = false;
+            {
+                std::lock_guard<std::mutex> lock(textureMutex);
+                if (restore) stats.restores++;
+                else stats.requests++;
+            }
+            releaseTexture(tex);
+        });
+    });
+}
+
+void touchTexture(Texture* tex)
+{
+    if (!tex) return;
+    tex->lastUsed = frame;
+
+    if (tex->reloading) return;
+    if (tex->resident && tex->droppedLevels == 0) return;
+    if (tex->failed) return;
+
+    // mipmaps de volta s se a cadeia inteira cabe; sem nenhum, volta sempre
+    if (tex->resident && budget) {
+        size_t full = tex->bytes << (2 * tex->droppedLevels);   // ~4x por nvel
+        size_t freed = tex->id ? tex->bytes : 0;                 // numa pgina, nada volta antes
+        if (gpuTextureBytes() - freed + full > budget) return;
+    }
+    reload(tex);
+}
+
+// O que pode sair junto para devolver VRAM: uma avulsa sozinha, ou todas
+// as texturas de um array ou do atlas (a pgina s  apagada vazia)
+struct BudgetUnit {
+    std::vector<Texture*> members;
+    uint64_t lastUsed = 0;   // a mais recente entre as texturas
+    bool busy = false;       // alguma usada no ltimo frame ou recarregando
+};
+
+// A unidade usada h mais tempo, fora das do ltimo frame
+static bool findVictim(BudgetUnit& victim)
+{
+    std::map<int, BudgetUnit> pages;
+    bool found = false;
+    auto consider = [&](const BudgetUnit& u) {
+        if (u.busy || (found && u.lastUsed >= victim.lastUsed)) return;
+        victim = u;
+        found = true;
+    };
+
+    std::lock_guard<std::mutex> lock(textureMutex);
+    for (auto& kv : textures)
+    {
+        Texture* t = kv.second;
+        if (!t->resident) continue;
+
+        BudgetUnit single;
+        BudgetUnit& u = (t->page == TEXTURE_STANDALONE) ? single : pages[t->page];
+        u.members.push_back(t);
+        u.lastUsed = std::max(u.lastUsed, t->lastUsed);
+        u.busy = u.busy || t->reloading || t->lastUsed + 1 >= frame;
+        if (t->page == TEXTURE_STANDALONE) consider(single);
+    }
+    for (auto& kv : pages)
+        consider(kv.second);
+    return found;
+}
+
+void enforceTextureBudget()
+{
+    frame++;
+    if (!budget) return;
+
+    for (int n = 0; n < MAX_EVICTIONS_PER_FRAME; n++)
+    {
+        if (gpuTextureBytes() <= budget) return;
+
+        BudgetUnit victim;
+        if (!findVictim(victim)) return;
+
+        // sozinha no lugar: perde um mipmap; pgina com vrias: saem todas
+        if (victim.members.size() == 1 && demote(victim.members[0])) continue;
+        for (Texture* t : victim.members)
+            evict(t);
+    }
+}
+
+glm::vec4 textureAverageColor(const Texture* tex)
+{
+    std::lock_guard<std::mutex> lock(textureMutex);
+    return tex->averageColor;
+}
+
+TextureCacheStats textureCacheStats()
+{
+    std::lock_guard<std::mutex> lock(textureMutex);
+    return stats;
+}
+
+void printTextureCacheStats()
+{
+    TextureCacheStats s = textureCacheStats();
+    std::cout << "[Texturas] " << s.textures << " no cache, " << s.misses << " decodificadas, " << s.ddsLoads << " do cache .dds, "
+        << s.hits << " reaproveitadas, " << s.residentBytes / 1024 << " KB em uso\n";
+
+    size_t full = 0, demoted = 0, evicted = 0, unused = 0;
+    {
+        std::lock_guard<std::mutex> lock(textureMutex);
+        for (auto& kv : textures) {
+            const Texture* t = kv.second;
+            if (!t->requested) unused++;
+            else if (!t->resident) evicted++;
+            else if (t->droppedLevels > 0) demoted++;
+            else full++;
+        }
+    }
+    std::cout << "[Texturas] oramento " << (budget ? std::to_string(budget / 1024) + " KB" : std::string("ilimitado"))
+        << ", " << full << " completas, " << demoted << " com mipmaps a menos, " << evicted << " fora da GPU; "
+        << unused << " nunca desenhadas; " << s.requests << " pedidas sob demanda, "
+        << s.demotions << " redues, " << s.evictions << " remoes, " << s.restores << " recargas; na GPU "
+        << texturePagesBytes() / 1024 << " KB em arrays/atlas + " << s.standaloneBytes / 1024 << " KB avulsas\n";
+}
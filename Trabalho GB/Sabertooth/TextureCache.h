@@ -0,0 +1,117 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "TextureDDS.h"
+
+// Onde uma textura mora na GPU: camada de um dos arrays de TextureArrays
+// (ndice >= 0), regio do atlas ou textura avulsa prpria. Fora da GPU o
+// material usa s a cor mdia (TEXTURE_PLACEHOLDER, na tabela de materiais).
+enum TexturePlacement {
+    TEXTURE_STANDALONE = -1,
+    TEXTURE_ATLAS = -2,
+    TEXTURE_PLACEHOLDER = -3
+};
+
+// Cache de texturas do processo inteiro, indexado pelo caminho cannico da
+// imagem. Materiais de qualquer .mtl que apontem para o mesmo arquivo
+// recebem a mesma textura: a imagem  decodificada e enviada uma nica vez,
+// e s quando algum grupo que a usa  desenhado pela primeira vez.
+struct Texture {
+    std::string path;
+    GLuint id = 0;                     // s nas avulsas
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    DDSImage dds;                      // nveis aguardando upload
+    size_t bytes = 0;                  // ocupados na GPU (com mipmaps)
+    int refs = 0;
+
+    // escritos pela thread de carregamento e lidos na do GL
+    std::atomic<bool> resident{ false };
+    int page = TEXTURE_STANDALONE;     // TexturePlacement ou ndice do array
+    int layer = 0;                     // camada no array
+    glm::vec4 atlasRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);   // offset.xy, escala.zw no atlas
+    glm::vec4 averageColor = glm::vec4(1.0f);                  // substituta fora da GPU (textureAverageColor)
+
+    // residncia (touchTexture, enforceTextureBudget)
+    bool requested = false;            // j foi pedida alguma vez
+    std::atomic<bool> failed{ false }; // imagem ilegvel: fica na cor mdia
+    uint64_t lastUsed = 0;             // frame do ltimo touchTexture
+    int droppedLevels = 0;             // mipmaps de cima descartados pelo oramento
+    bool reloading = false;
+    uint64_t sourceHash = 0;           // da imagem, para reler o .dds
+    uint64_t sourceSize = 0;
+
+    // estado do carregamento (streamTextures)
+    std::mutex decodeMutex;
+    std::atomic<bool> decoded{ false };
+    std::atomic<bool> staged{ false };
+    GLuint pbo = 0;
+    void* staging = nullptr;           // PBO mapeado
+};
+
+struct TextureCacheStats {
+    size_t hits = 0;            // pedidos atendidos por uma textura j no cache
+    size_t misses = 0;          // imagens decodificadas
+    size_t ddsLoads = 0;        // lidas j comprimidas do cache .dds
+    size_t textures = 0;        // texturas vivas no cache
+    size_t residentBytes = 0;   // soma de Texture::bytes das texturas na GPU
+    size_t standaloneBytes = 0; // s as avulsas; com texturePagesBytes(), a VRAM real
+    size_t demotions = 0;       // mipmaps descartados pelo oramento
+    size_t evictions = 0;       // texturas tiradas da GPU pelo oramento
+    size_t restores = 0;        // recargas depois de redues/remoes
+    size_t requests = 0;        // primeiras cargas, pedidas por touchTexture
+};
+
+// Liga/desliga a compresso BC1/BC3 das texturas carregadas daqui em
+// diante. Depende de GL_EXT_texture_compression_s3tc; sem ela o .dds guarda
+// os mipmaps em RGB/RGBA.
+void setTextureCompression(bool enabled);
+
+// Textura da imagem em `path` (qualquer thread). S registra a entrada e l
+// a cor mdia do .dds, se houver; a decodificao fica para touchTexture,
+// streamTextures ou uploadTexture.
+Texture* acquireTexture(const std::string& path);
+
+// Solta uma referncia; a ltima apaga a textura da GPU (thread do GL).
+void releaseTexture(Texture* tex);
+
+// Fora da thread do GL: decodifica as imagens em paralelo, copia os nveis
+// para PBOs mapeados e posta na fila do GL s a criao das texturas a
+// partir dos PBOs.
+void streamTextures(const std::vector<Texture*>& list);
+
+// Thread do GL: garante a textura na GPU, decodificando e enviando na hora
+// se ela no passou por streamTextures. No faz nada se j  residente.
+void uploadTexture(Texture* tex);
+
+// Oramento de VRAM das texturas (0 = sem limite), medido como a memria
+// reservada por arrays e atlas mais a das texturas avulsas. Acima dele,
+// enforceTextureBudget libera o que foi usado h mais tempo: uma avulsa, ou
+// um array/o atlas inteiro, que s devolvem memria quando esvaziam. Uma
+// textura sozinha na pgina perde o mipmap de cima (at MIN_DEMOTED_SIZE);
+// as demais saem da GPU.
+void setTextureBudget(size_t bytes);
+
+// Thread do GL: a textura vai ser desenhada neste frame. Pede a carga (em
+// segundo plano) da que nunca foi carregada e traz de volta a que foi
+// removida ou reduzida, se o oramento permitir. At l o material desenha
+// com a cor mdia.
+void touchTexture(Texture* tex);
+
+// Thread do GL, uma vez por frame: avana o relgio do LRU e aplica o
+// oramento.
+void enforceTextureBudget();
+
+// Cor da substituta: o 1x1 do .dds j na aquisio; sem .dds (primeira
+// execuo), branco at a imagem ser decodificada pela primeira vez.
+glm::vec4 textureAverageColor(const Texture* tex);
+
+TextureCacheStats textureCacheStats();
+void printTextureCacheStats();
@@ -0,0 +1,288 @@
+#include "TextureDDS.h"
+#include "TextureMips.h"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+extern "C" {
+#include "image_DXT.h"
+}
+
+// O .dds  um DDS comum (lido por qualquer ferramenta); o hash da imagem de
+// origem vai nos campos reservados do cabealho.
+static const uint32_t DDS_MAGIC = 0x20534444;        // "DDS "
+static const uint32_t FOURCC_DXT1 = 0x31545844;      // "DXT1"
+static const uint32_t FOURCC_DXT5 = 0x35545844;      // "DXT5"
+static const uint32_t CACHE_TAG = 0x48435453;        // "STCH"
+static const uint32_t CACHE_VERSION = 2;
+
+static size_t levelSize(GLenum format, int width, int height)
+{
+    switch (format) {
+    case GL_RGB:  return (size_t)width * height * 3;
+    case GL_RGBA: return (size_t)width * height * 4;
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT: return (size_t)((width + 3) / 4) * ((height + 3) / 4) * 8;
+    default:      return (size_t)((width + 3) / 4) * ((height + 3) / 4) * 16;
+    }
+}
+
+const unsigned char* DDSImage::data() const
+{
+    if (file) return (const unsigned char*)file->data() + fileOffset;
+    return blocks.data();
+}
+
+size_t DDSImage::size() const
+{
+    if (levels.empty()) return 0;
+    return levels.back().offset + levels.back().size;
+}
+
+void DDSImage::clear()
+{
+    levels.clear();
+    file.reset();
+    fileOffset = 0;
+    std::vector<unsigned char>().swap(blocks);
+}
+
+std::string ddsCachePath(const std::string& imagePath)
+{
+    return imagePath + ".dds";
+}
+
+bool bakeImage(const unsigned char* pixels, int width, int height, int channels, bool compress, DDSImage& out)
+{
+    out.clear();
+    if (!pixels || width < 1 || height < 1 || (channels != 3 && channels != 4)) return false;
+
+    if (compress) out.format = (channels == 3) ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else out.format = (channels == 3) ? GL_RGB : GL_RGBA;
+
+    std::vector<unsigned char> level;
+    const unsigned char* src = pixels;
+    int w = width, h = height;
+    while (true)
+    {
+        size_t offset = out.blocks.size();
+        if (compress)
+        {
+            int size = 0;
+            unsigned char* blocks = (channels == 3)
+                ? convert_image_to_DXT1(src, w, h, channels, &size)
+                : convert_image_to_DXT5(src, w, h, channels, &size);
+            if (!blocks) {
+                out.clear();
+                return false;
+            }
+            out.blocks.insert(out.blocks.end(), blocks, blocks + size);
+            free(blocks);
+        }
+        else
+        {
+            out.blocks.insert(out.blocks.end(), src, src + (size_t)w * h * channels);
+        }
+        out.levels.push_back({ w, h, offset, out.blocks.size() - offset });
+
+        if (w == 1 && h == 1) break;
+        level = downsampleLevel(src, w, h, channels);
+        src = level.data();
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    return true;
+}
+
+bool writeDDSCache(const std::string& imagePath, const DDSImage& image, uint64_t sourceHash, uint64_t sourceSize)
+{
+    if (image.empty()) return false;
+
+    std::string path = ddsCachePath(imagePath);
+    std::string tmpPath = path + ".tmp";
+
+    DDS_header header;
+    std::memset(&header, 0, sizeof(header));
+    header.dwMagic = DDS_MAGIC;
+    header.dwSize = 124;
+    header.dwFlags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT;
+    header.dwWidth = image.levels[0].width;
+    header.dwHeight = image.levels[0].height;
+    header.dwMipMapCount = (unsigned int)image.levels.size();
+    header.dwReserved1[0] = CACHE_TAG;
+    header.dwReserved1[1] = CACHE_VERSION;
+    header.dwReserved1[2] = (unsigned int)(sourceHash & 0xFFFFFFFF);
+    header.dwReserved1[3] = (unsigned int)(sourceHash >> 32);
+    header.dwReserved1[4] = (unsigned int)(sourceSize & 0xFFFFFFFF);
+    header.dwReserved1[5] = (unsigned int)(sourceSize >> 32);
+    header.sPixelFormat.dwSize = 32;
+    if (image.compressed())
+    {
+        header.dwFlags |= DDSD_LINEARSIZE;
+        header.dwPitchOrLinearSize = (unsigned int)image.levels[0].size;
+        header.sPixelFormat.dwFlags = DDPF_FOURCC;
+        header.sPixelFormat.dwFourCC = (image.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) ? FOURCC_DXT1 : FOURCC_DXT5;
+    }
+    else
+    {
+        // bytes na ordem R, G, B(, A), descritos pelas mscaras
+        unsigned int bpp = (image.format == GL_RGBA) ? 4 : 3;
+        header.dwFlags |= DDSD_PITCH;
+        header.dwPitchOrLinearSize = image.levels[0].width * bpp;
+        header.sPixelFormat.dwFlags = DDPF_RGB | (bpp == 4 ? DDPF_ALPHAPIXELS : 0);
+        header.sPixelFormat.dwRGBBitCount = bpp * 8;
+        header.sPixelFormat.dwRBitMask = 0x000000FF;
+        header.sPixelFormat.dwGBitMask = 0x0000FF00;
+        header.sPixelFormat.dwBBitMask = 0x00FF0000;
+        header.sPixelFormat.dwAlphaBitMask = (bpp == 4) ? 0xFF000000 : 0;
+    }
+    header.sCaps.dwCaps1 = DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[DDS] AVISO: no foi possvel criar " << tmpPath << std::endl;
+        return false;
+    }
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)image.data(), image.size());
+    out.close();
+    if (!out) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    // troca atmica, como no .smesh
+    std::remove(path.c_str());
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    std::cout << "[DDS] Cache gravado: " << path << " (" << image.size() / 1024 << " KB, "
+        << image.levels.size() << " nveis)\n";
+    return true;
+}
+
+// Mapeia o .dds e monta os nveis, sem conferir a imagem de origem
+static bool mapDDSCache(const std::string& imagePath, DDSImage& out, uint64_t& sourceHash, uint64_t& sourceSize)
+{
+    out.clear();
+
+    std::string path = ddsCachePath(imagePath);
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    if (!file->open(path))
+        return false;
+
+    DDS_header header;
+    if (file->size() < sizeof(header)) return false;
+    std::memcpy(&header, file->data(), sizeof(header));
+
+    if (header.dwMagic != DDS_MAGIC ||
+        header.dwReserved1[0] != CACHE_TAG ||
+        header.dwReserved1[1] != CACHE_VERSION)
+    {
+        std::cout << "[DDS] Cache em formato antigo, ignorando: " << path << "\n";
+        return false;
+    }
+
+    sourceHash = header.dwReserved1[2] | ((uint64_t)header.dwReserved1[3] << 32);
+    sourceSize = header.dwReserved1[4] | ((uint64_t)header.dwReserved1[5] << 32);
+
+    const auto& pf = header.sPixelFormat;
+    if ((pf.dwFlags & DDPF_FOURCC) && pf.dwFourCC == FOURCC_DXT1) out.format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    else if ((pf.dwFlags & DDPF_FOURCC) && pf.dwFourCC == FOURCC_DXT5) out.format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else if ((pf.dwFlags & DDPF_RGB) && pf.dwRBitMask == 0xFF && pf.dwRGBBitCount == 24) out.format = GL_RGB;
+    else if ((pf.dwFlags & DDPF_RGB) && pf.dwRBitMask == 0xFF && pf.dwRGBBitCount == 32) out.format = GL_RGBA;
+    else return false;
+
+    int w = (int)header.dwWidth, h = (int)header.dwHeight;
+    size_t offset = 0;
+    for (unsigned int l = 0; l < header.dwMipMapCount && w > 0 && h > 0; l++)
+    {
+        size_t bytes = levelSize(out.format, w, h);
+        out.levels.push_back({ w, h, offset, bytes });
+        offset += bytes;
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+
+    if (out.levels.empty() || sizeof(header) + offset > file->size()) {
+        std::cerr << "[DDS] AVISO: cache corrompido: " << path << std::endl;
+        out.clear();
+        return false;
+    }
+
+    out.file = file;
+    out.fileOffset = sizeof(header);
+    return true;
+}
+
+bool loadDDSCache(const std::string& imagePath, uint64_t sourceHash, uint64_t sourceSize, DDSImage& out)
+{
+    uint64_t hash, size;
+    if (!mapDDSCache(imagePath, out, hash, size))
+        return false;
+
+    if (hash != sourceHash || size != sourceSize) {
+        std::cout << "[DDS] Cache desatualizado: " << ddsCachePath(imagePath) << "\n";
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+static glm::vec4 unpack565(unsigned int c)
+{
+    return glm::vec4(((c >> 11) & 31) / 31.0f, ((c >> 5) & 63) / 63.0f, (c & 31) / 31.0f, 1.0f);
+}
+
+// Primeiro texel de um nvel (num bloco BC1/BC3, o do canto)
+static glm::vec4 firstTexel(GLenum format, const unsigned char* p)
+{
+    if (format == GL_RGB) return glm::vec4(p[0], p[1], p[2], 255.0f) / 255.0f;
+    if (format == GL_RGBA) return glm::vec4(p[0], p[1], p[2], p[3]) / 255.0f;
+
+    // BC3: 8 bytes de alfa antes do bloco de cor
+    float alpha = 1.0f;
+    if (format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+    {
+        float a0 = p[0] / 255.0f, a1 = p[1] / 255.0f;
+        int i = p[2] & 7;
+        if (i == 0) alpha = a0;
+        else if (i == 1) alpha = a1;
+        else if (a0 > a1) alpha = ((8 - i) * a0 + (i - 1) * a1) / 7.0f;
+        else alpha = (i == 6) ? 0.0f : (i == 7) ? 1.0f : ((6 - i) * a0 + (i - 1) * a1) / 5.0f;
+        p += 8;
+    }
+
+    unsigned int c0 = p[0] | (p[1] << 8);
+    unsigned int c1 = p[2] | (p[3] << 8);
+    glm::vec4 e0 = unpack565(c0), e1 = unpack565(c1), color;
+    switch (p[4] & 3) {
+    case 0:  color = e0; break;
+    case 1:  color = e1; break;
+    case 2:  color = (c0 > c1) ? (2.0f * e0 + e1) / 3.0f : (e0 + e1) * 0.5f; break;
+    default: color = (c0 > c1) ? (e0 + 2.0f * e1) / 3.0f : glm::vec4(0.0f); break;
+    }
+    color.a = alpha;
+    return color;
+}
+
+glm::vec4 averageColor(const DDSImage& image)
+{
+    if (image.empty() || !image.data()) return glm::vec4(1.0f);
+    return firstTexel(image.format, image.data() + image.levels.back().offset);
+}
+
+bool readDDSAverageColor(const std::string& imagePath, glm::vec4& color)
+{
+    DDSImage image;
+    uint64_t hash, size;
+    if (!mapDDSCache(imagePath, image, hash, size))
+        return false;
+
+    color = averageColor(image);
+    return true;
+}
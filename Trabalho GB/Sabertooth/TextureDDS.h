@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "MappedFile.h"
+
+// Cache de texturas (.dds), gravado ao lado da imagem de origem. Guarda a
+// cadeia de mipmaps inteira, j filtrada, em BC1 (DXT1, sem alfa), BC3
+// (DXT5, com alfa) ou RGB/RGBA sem compresso, junto com o hash da imagem
+// que o gerou.
+
+struct TextureLevel {
+    int width;
+    int height;
+    size_t offset;   // a partir de DDSImage::data()
+    size_t size;
+};
+
+struct DDSImage {
+    GLenum format = 0;   // GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_RGB ou GL_RGBA
+    std::vector<TextureLevel> levels;
+
+    // blocos vindos do .dds mapeado ou recm comprimidos
+    std::shared_ptr<MappedFile> file;
+    size_t fileOffset = 0;
+    std::vector<unsigned char> blocks;
+
+    bool empty() const { return levels.empty(); }
+    bool compressed() const { return format != GL_RGB && format != GL_RGBA; }
+    const unsigned char* data() const;
+    size_t size() const;
+    void clear();
+};
+
+// Caminho do .dds correspondente a uma imagem ("wood.jpg" -> "wood.jpg.dds").
+std::string ddsCachePath(const std::string& imagePath);
+
+// Gera a cadeia de mipmaps de uma imagem decodificada (RGB ou RGBA) e,
+// com `compress`, comprime todos os nveis.
+bool bakeImage(const unsigned char* pixels, int width, int height, int channels, bool compress, DDSImage& out);
+
+// Grava o .dds de uma imagem j processada por bakeImage.
+bool writeDDSCache(const std::string& imagePath, const DDSImage& image, uint64_t sourceHash, uint64_t sourceSize);
+
+// Mapeia o .dds da imagem. Falha se ele no existe, no foi gravado por
+// writeDDSCache ou a imagem mudou desde ento.
+bool loadDDSCache(const std::string& imagePath, uint64_t sourceHash, uint64_t sourceSize, DDSImage& out);
+
+// Cor mdia da imagem: o ltimo nvel da cadeia (1x1), j filtrado com
+// gama correto pelo bakeImage.
+glm::vec4 averageColor(const DDSImage& image);
+
+// S a cor mdia, lida do .dds sem decodificar nem conferir a imagem de
+// origem (serve de substituta enquanto a textura no chega). Falha sem .dds.
+bool readDDSAverageColor(const std::string& imagePath, glm::vec4& color);
@@ -0,0 +1,137 @@
+#include "TextureMips.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIPS_SSE2 1
+#endif
+
+// sRGB -> linear para os 256 valores de entrada, e linear -> sRGB amostrado
+// fino o bastante para no perder degraus nos tons escuros
+static const int TO_SRGB_STEPS = 16384;
+
+struct GammaTables {
+    float toLinear[256];
+    unsigned char toSRGB[TO_SRGB_STEPS + 1];
+
+    GammaTables()
+    {
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            toLinear[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i <= TO_SRGB_STEPS; i++) {
+            float l = (float)i / TO_SRGB_STEPS;
+            float c = (l <= 0.0031308f) ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            toSRGB[i] = (unsigned char)std::min(255.0f, c * 255.0f + 0.5f);
+        }
+    }
+};
+
+static const GammaTables& gammaTables()
+{
+    static const GammaTables tables;
+    return tables;
+}
+
+// Linha de entrada convertida para linear (alfa s normalizado)
+static void rowToLinear(const unsigned char* src, int count, int channels, float* dst)
+{
+    const GammaTables& t = gammaTables();
+    bool hasAlpha = (channels == 2 || channels == 4);
+    for (int i = 0; i < count; i++)
+    {
+        for (int c = 0; c < channels; c++)
+        {
+            unsigned char v = src[i * channels + c];
+            dst[i * channels + c] = (hasAlpha && c == channels - 1) ? v / 255.0f : t.toLinear[v];
+        }
+    }
+}
+
+// a[i] += (b[i] - a[i]) * weight: 0.5 soma a segunda linha, 1/3 a terceira
+static void mixRows(float* a, const float* b, float weight, int count)
+{
+    int i = 0;
+#ifdef MIPS_SSE2
+    const __m128 w = _mm_set1_ps(weight);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 va = _mm_loadu_ps(a + i);
+        _mm_storeu_ps(a + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b + i), va), w)));
+    }
+#endif
+    for (; i < count; i++)
+        a[i] += (b[i] - a[i]) * weight;
+}
+
+std::vector<unsigned char> downsampleLevel(const unsigned char* src, int width, int height, int channels)
+{
+    int w = std::max(1, width / 2);
+    int h = std::max(1, height / 2);
+    std::vector<unsigned char> dst((size_t)w * h * channels);
+
+    const GammaTables& t = gammaTables();
+    bool hasAlpha = (channels == 2 || channels == 4);
+    int rowFloats = width * channels;
+    std::vector<float> top(rowFloats), bottom(rowFloats);
+
+    // com tamanho mpar (> 1) o ltimo texel de sada cobre 3 de entrada,
+    // seno a ltima linha/coluna sumiria do nvel seguinte
+    bool oddWidth = (width & 1) && width > 1;
+    bool oddHeight = (height & 1) && height > 1;
+    int pairEnd = oddWidth ? w - 1 : width / 2;   // texels de sada com exatamente 2 colunas
+
+    for (int y = 0; y < h; y++)
+    {
+        int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+        rowToLinear(src + (size_t)y0 * rowFloats, width, channels, top.data());
+        rowToLinear(src + (size_t)y1 * rowFloats, width, channels, bottom.data());
+        mixRows(top.data(), bottom.data(), 0.5f, rowFloats);
+        if (oddHeight && y == h - 1)
+        {
+            rowToLinear(src + (size_t)(2 * y + 2) * rowFloats, width, channels, bottom.data());
+            mixRows(top.data(), bottom.data(), 1.0f / 3.0f, rowFloats);
+        }
+
+        unsigned char* out = dst.data() + (size_t)y * w * channels;
+        int x = 0;
+#ifdef MIPS_SSE2
+        // RGBA: um texel por registrador, dois somados por vez
+        if (channels == 4)
+        {
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 steps = _mm_set_ps(255.0f, (float)TO_SRGB_STEPS, (float)TO_SRGB_STEPS, (float)TO_SRGB_STEPS);
+            for (; x < pairEnd; x++)
+            {
+                __m128 a = _mm_loadu_ps(&top[(2 * x) * 4]);
+                __m128 b = _mm_loadu_ps(&top[(2 * x + 1) * 4]);
+                __m128 v = _mm_mul_ps(_mm_mul_ps(_mm_add_ps(a, b), half), steps);
+                int idx[4];
+                _mm_storeu_si128((__m128i*)idx, _mm_cvtps_epi32(v));
+                out[x * 4 + 0] = t.toSRGB[idx[0]];
+                out[x * 4 + 1] = t.toSRGB[idx[1]];
+                out[x * 4 + 2] = t.toSRGB[idx[2]];
+                out[x * 4 + 3] = (unsigned char)idx[3];
+            }
+        }
+#endif
+        for (; x < w; x++)
+        {
+            int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+            bool threeTaps = (x >= pairEnd && oddWidth);
+            for (int c = 0; c < channels; c++)
+            {
+                float v = (top[x0 * channels + c] + top[x1 * channels + c]) * 0.5f;
+                if (threeTaps)
+                    v += (top[(2 * x + 2) * channels + c] - v) * (1.0f / 3.0f);
+                if (hasAlpha && c == channels - 1)
+                    out[x * channels + c] = (unsigned char)(v * 255.0f + 0.5f);
+                else
+                    out[x * channels + c] = t.toSRGB[(int)(v * TO_SRGB_STEPS + 0.5f)];
+            }
+        }
+    }
+    return dst;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <vector>
+
+// Reduo de mipmaps com correo de gama: as cores (sRGB) so convertidas
+// para linear, a mdia 2x2  feita em linear e o resultado volta para sRGB.
+// Em dimenses mpares o ltimo texel de sada usa 3 amostras naquele eixo.
+// O alfa (ltimo canal de imagens com 2 ou 4 canais)  filtrado direto.
+
+// Prximo nvel da cadeia (dimenses max(1, w/2) x max(1, h/2)).
+std::vector<unsigned char> downsampleLevel(const unsigned char* src, int width, int height, int channels);
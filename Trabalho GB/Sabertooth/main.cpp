@@ -14,10 +14,19 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "SceneLoader.h"
-#include "Renderer.h"
 #include "Camera.h"
 #include "Editor2D.h"
+#include "AssetCache.h"
 #include "ObjLoader.h"
+#include "AsyncLoader.h"
+#include "TextureCache.h"
+#include "TextureArrays.h"
+#include "MaterialTable.h"
+#include "ShaderProgram.h"
+#include "FrameUniforms.h"
+#include "RenderQueue.h"
+#include "Culling.h"
+#include "StaticBatch.h"
 #include "Projectile.h"
 
 enum AppMode { MODE_EDITOR_2D = 0, MODE_3D = 1 };
@@ -30,12 +39,14 @@ float lastFrame = 0.0f;
 
 bool mouseCaptured = false;
 
-static const int MAX_LIGHTS = 8;
 bool globalLightEnabled = true;
 bool lightEnabled[MAX_LIGHTS] = { true,true,true,true,true,true,true,true };
+bool lightsDirty = true;   // reenviar o bloco Lights (cena nova ou interruptor)
 
 Scene* scene = nullptr;
-GLuint shader = 0;
+ShaderProgram shader;
+ShaderProgram indirectShader;   // GL 4.3+: multi-draw indireto (RenderQueue)
+bool useIndirectDraw = false;   // tecla I alterna quando disponvel
 
 Editor2D editor;
 
@@ -51,11 +62,252 @@ float carTravelS = 0.0f;
 
 Obj3D* carObj = nullptr;
 Obj3D* projectileObj = nullptr;
+ProjectileManager projectileManager;
 glm::vec3 carOriginalScale(1.0f);
 float carMinYLocal = 0.0f;
 
 glm::mat4 proj;
 
+// tempo mximo por frame gasto com uploads vindos do carregamento assncrono
+const double GL_UPLOAD_BUDGET_MS = 4.0;
+
+// VRAM para texturas; acima disso as menos usadas perdem mipmaps ou saem
+const size_t TEXTURE_BUDGET_MB = 512;
+
+const float FOV_DEGREES = 60.0f;
+const float SCREEN_WIDTH = 800.0f;
+const float SCREEN_HEIGHT = 600.0f;
+
+// erro mximo de simplificao aceito na tela, em pixels
+const float LOD_PIXEL_ERROR = 1.0f;
+
+// tecla B: objetos e frames medidos por caminho de desenho
+const int BENCH_OBJECTS = 10000;
+const int BENCH_FRAMES = 30;
+
+// tecla O: OBJ sinttico para comparar o parser mapeado com o antigo
+const char* BENCH_OBJ_PATH = "bench_5m.obj";
+const size_t BENCH_OBJ_FACES = 5000000;
+
+struct InstanceBatch {
+    Mesh* mesh;
+    int lod;
+    std::vector<glm::mat4> models;
+    std::vector<uint8_t> groupVisible;   // grupo visvel em alguma instncia
+};
+std::vector<InstanceBatch> instanceBatches;
+
+// Leva de instncias da malha no nvel `lod`, criada na primeira vez
+InstanceBatch* findBatch(Mesh* mesh, int lod)
+{
+    for (InstanceBatch& b : instanceBatches)
+        if (b.mesh == mesh && b.lod == lod) return &b;
+    instanceBatches.push_back({ mesh, lod, {}, {} });
+    return &instanceBatches.back();
+}
+
+// Nvel de detalhe mais simples cujo erro, projetado  distncia do objeto,
+// fica abaixo de LOD_PIXEL_ERROR.
+int selectLod(const Obj3D* obj)
+{
+    const Mesh* mesh = obj->mesh;
+    int count = mesh->lodCount();
+    if (count <= 1) return 0;
+
+    glm::vec3 localCenter = (mesh->boundsMin + mesh->boundsMax) * 0.5f;
+    float localRadius = glm::length(mesh->boundsMax - mesh->boundsMin) * 0.5f;
+
+    const glm::mat4& m = obj->transform;
+    float scale = std::max(glm::length(glm::vec3(m[0])), std::max(glm::length(glm::vec3(m[1])), glm::length(glm::vec3(m[2]))));
+    glm::vec3 center = glm::vec3(m * glm::vec4(localCenter, 1.0f));
+
+    float distance = glm::length(center - camera.position) - localRadius * scale;
+    if (distance <= 0.0f) return 0;
+
+    // pixels ocupados por uma unidade do modelo a essa distncia
+    float pixelsPerUnit = scale * (SCREEN_HEIGHT * 0.5f) / (distance * std::tan(glm::radians(FOV_DEGREES) * 0.5f));
+
+    int lod = 0;
+    while (lod + 1 < count && mesh->lodError(lod + 1) * pixelsPerUnit <= LOD_PIXEL_ERROR)
+        lod++;
+    return lod;
+}
+
+// culling do ltimo frame (tecla R)
+CullStats cullStats;
+BoxList cullObjectBoxes, cullGroupBoxes, cullStaticBoxes;
+std::vector<uint8_t> cullObjectVisible, cullGroupVisible, cullStaticVisible;
+std::vector<Obj3D*> cullObjects;
+std::vector<Group*> visibleStaticDraws;
+
+// Monta as levas de instncias s com o que est no frustum: objetos e
+// projteis num lote contra os planos da cmera; dos objetos visveis com
+// mais de um grupo, os grupos num segundo lote. Numa leva, um grupo 
+// desenhado se aparece em pelo menos uma das instncias. Objetos j nas
+// pginas estticas ficam de fora; as faixas delas so testadas  parte.
+void cullAndBatch(const glm::vec4 frustum[6])
+{
+    cullStats = CullStats();
+    for (InstanceBatch& b : instanceBatches) {
+        b.models.clear();
+        b.groupVisible.assign(b.mesh->groups.size(), 0);
+    }
+
+    cullObjectBoxes.clear();
+    cullObjects.clear();
+    for (Obj3D* obj : scene->objects)
+    {
+        if (!obj || !obj->mesh || obj->mesh->groups.empty() || obj->staticBatched)
+            continue;
+
+        obj->updateWorldBounds();
+        cullObjectBoxes.add(obj->worldMin, obj->worldMax);
+        cullObjects.push_back(obj);
+    }
+
+    Mesh* projectileMesh = (projectileObj && projectileObj->mesh && !projectileObj->mesh->groups.empty())
+        ? projectileObj->mesh : nullptr;
+    if (projectileMesh)
+    {
+        for (const Projectile& p : projectileManager.projectiles) {
+            glm::vec3 mn, mx;
+            transformBounds(p.model, projectileMesh->boundsMin, projectileMesh->boundsMax, mn, mx);
+            cullObjectBoxes.add(mn, mx);
+        }
+    }
+
+    cullBoxes(frustum, cullObjectBoxes, cullObjectVisible);
+
+    // grupos dos objetos visveis
+    cullGroupBoxes.clear();
+    for (size_t i = 0; i < cullObjects.size(); i++)
+    {
+        const Obj3D* obj = cullObjects[i];
+        if (!cullObjectVisible[i] || obj->mesh->groups.size() < 2) continue;
+        for (size_t g = 0; g < obj->mesh->groups.size(); g++)
+            cullGroupBoxes.add(obj->groupWorldMin[g], obj->groupWorldMax[g]);
+    }
+    cullStats.groups = cullGroupBoxes.size();
+    cullStats.groupsVisible = cullBoxes(frustum, cullGroupBoxes, cullGroupVisible);
+
+    size_t nextGroup = 0;
+    cullStats.objects = cullObjects.size();
+    for (size_t i = 0; i < cullObjects.size(); i++)
+    {
+        if (!cullObjectVisible[i]) continue;
+        cullStats.objectsVisible++;
+
+        Obj3D* obj = cullObjects[i];
+        InstanceBatch* batch = findBatch(obj->mesh, selectLod(obj));
+        batch->models.push_back(obj->transform);
+        batch->groupVisible.resize(obj->mesh->groups.size(), 0);
+
+        if (obj->mesh->groups.size() < 2) {
+            batch->groupVisible[0] = 1;
+            continue;
+        }
+        for (size_t g = 0; g < obj->mesh->groups.size(); g++)
+            batch->groupVisible[g] |= cullGroupVisible[nextGroup++];
+    }
+
+    // projteis vivos: uma leva s da malha deles (junto com objetos da
+    // cena que usem a mesma), um draw por grupo para qualquer quantidade
+    if (projectileMesh)
+    {
+        InstanceBatch* batch = nullptr;
+        size_t box = cullObjects.size();
+        cullStats.projectiles = projectileManager.projectiles.size();
+        for (const Projectile& p : projectileManager.projectiles)
+        {
+            if (!cullObjectVisible[box++]) continue;
+            if (!batch) {
+                batch = findBatch(projectileMesh, 0);
+                batch->groupVisible.assign(projectileMesh->groups.size(), 1);
+            }
+            batch->models.push_back(p.model);
+            cullStats.projectilesVisible++;
+        }
+    }
+
+    // faixas das pginas estticas, com bounds j em mundo
+    const std::vector<Group*>& statics = staticDraws();
+    cullStaticBoxes.clear();
+    for (const Group* d : statics)
+        cullStaticBoxes.add(d->boundsMin, d->boundsMax);
+    cullStats.staticDraws = statics.size();
+    cullStats.staticDrawsVisible = cullBoxes(frustum, cullStaticBoxes, cullStaticVisible);
+
+    visibleStaticDraws.clear();
+    for (size_t i = 0; i < statics.size(); i++)
+        if (cullStaticVisible[i]) visibleStaticDraws.push_back(statics[i]);
+}
+
+// Um caminho de desenho no benchmark: cada grupo de cada objeto enfileirado
+//  parte (sem instncias), para medir o custo por draw. Tempo de CPU at o
+// fim do flush e total at o glFinish, na mdia dos frames medidos.
+void benchmarkDrawPath(const char* label, const ShaderProgram& program, Mesh* mesh,
+                       const std::vector<glm::mat4>& models, const glm::mat4& view)
+{
+    double cpu = 0.0, total = 0.0;
+    for (int frame = -2; frame < BENCH_FRAMES; frame++)   // 2 de aquecimento
+    {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        double t0 = glfwGetTime();
+        beginRenderQueue(view);
+        for (const glm::mat4& model : models)
+            for (Group* g : mesh->groups)
+                submitGroup(program, g, 0, &model);
+        flushRenderQueue();
+        double t1 = glfwGetTime();
+        glFinish();
+        double t2 = glfwGetTime();
+
+        if (frame >= 0) {
+            cpu += t1 - t0;
+            total += t2 - t0;
+        }
+    }
+
+    RenderQueueStats s = renderQueueStats();
+    std::cout << "[Bench] " << label << ": " << s.draws << " chamadas de draw (" << s.commands << " comandos), CPU "
+        << cpu * 1000.0 / BENCH_FRAMES << " ms, CPU+GPU " << total * 1000.0 / BENCH_FRAMES << " ms por frame\n";
+}
+
+// BENCH_OBJECTS cubos (a malha dos projteis) numa grade  frente da
+// cmera, desenhados pelo caminho GL 3.3 e, se houver, pelo indireto.
+void runDrawBenchmark()
+{
+    Mesh* mesh = projectileObj ? projectileObj->mesh : nullptr;
+    if (!mesh || mesh->groups.empty()) {
+        std::cout << "[Bench] Malha do cubo ainda carregando\n";
+        return;
+    }
+
+    int side = (int)std::ceil(std::sqrt((float)BENCH_OBJECTS));
+    glm::vec3 center = camera.position + camera.front * 40.0f;
+    std::vector<glm::mat4> models;
+    for (int i = 0; i < BENCH_OBJECTS; i++)
+    {
+        float x = (float)(i % side) - side * 0.5f;
+        float y = (float)(i / side) - side * 0.5f;
+        glm::vec3 pos = center + camera.right * (x * 0.4f) + camera.up * (y * 0.4f);
+        models.push_back(glm::scale(glm::translate(glm::mat4(1.0f), pos), glm::vec3(0.1f)));
+    }
+
+    glm::mat4 view = camera.getViewMatrix();
+    updateFrameUniforms(view, proj, camera.position);
+    bindTexturePages();
+    updateMaterialTable();
+
+    std::cout << "[Bench] " << BENCH_OBJECTS << " objetos, " << mesh->groups.size() << " grupo(s) cada\n";
+    benchmarkDrawPath("GL 3.3, um draw por grupo", shader, mesh, models, view);
+    if (indirectShader.id)
+        benchmarkDrawPath("GL 4.3, multi-draw indireto", indirectShader, mesh, models, view);
+    else
+        std::cout << "[Bench] Multi-draw indireto indisponvel (requer GL 4.3)\n";
+}
+
 void setMouseCaptured(GLFWwindow* window, bool state)
 {
     mouseCaptured = state;
@@ -76,8 +328,6 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos)
         camera.processMouseMovement((float)xpos, (float)ypos);
 }
 
-ProjectileManager projectileManager;
-
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
     if (mode != MODE_3D) return;
@@ -202,28 +452,23 @@ void processInput(GLFWwindow* window)
                 if (!scene) {
                     scene = loadScene("scene.txt");
                     if (!scene) exit(1);
+                    lightsDirty = true;
                 }
 
                 if (!scene->objects.empty()) {
                     carObj = scene->objects[0];
-					projectileObj = loadOBJ("Cube.obj");
+                    carObj->isStatic = false;   // anda pela pista
+					projectileObj = new Obj3D();
+					requestMesh("Cube.obj", projectileObj);
 
                     glm::mat4 t = carObj->transform;
                     carOriginalScale.x = glm::length(glm::vec3(t[0][0], t[1][0], t[2][0]));
                     carOriginalScale.y = glm::length(glm::vec3(t[0][1], t[1][1], t[2][1]));
                     carOriginalScale.z = glm::length(glm::vec3(t[0][2], t[1][2], t[2][2]));
-
-                    if (carObj->mesh && !carObj->mesh->vertices.empty()) {
-                        float minY = carObj->mesh->vertices[0].y;
-                        for (auto& v : carObj->mesh->vertices)
-                            if (v.y < minY) minY = v.y;
-
-                        carMinYLocal = minY;
-                    }
                 }
 
                 buildCarPathFromEditor();
-                glUseProgram(shader);
+                glUseProgram(shader.id);
             }
             enterPressed = true;
         }
@@ -256,10 +501,56 @@ void processInput(GLFWwindow* window)
     }
     else escPressed = false;
 
+    // contagens de draws e trocas de estado do ltimo frame
+    static bool Rpressed = false;
+    if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
+        if (!Rpressed) {
+            printCullStats(cullStats);
+            printRenderQueueStats();
+            printTextureCacheStats();
+            Rpressed = true;
+        }
+    }
+    else Rpressed = false;
+
+    static bool Ipressed = false;
+    if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS) {
+        if (!Ipressed) {
+            if (indirectShader.id) {
+                useIndirectDraw = !useIndirectDraw;
+                std::cout << "[Render] Caminho " << (useIndirectDraw ? "multi-draw indireto (GL 4.3)" : "GL 3.3") << "\n";
+            }
+            else std::cout << "[Render] Multi-draw indireto indisponvel (requer GL 4.3)\n";
+            Ipressed = true;
+        }
+    }
+    else Ipressed = false;
+
+    static bool Bpressed = false;
+    if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS) {
+        if (!Bpressed) {
+            runDrawBenchmark();
+            Bpressed = true;
+        }
+    }
+    else Bpressed = false;
+
+    static bool Opressed = false;
+    if (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS) {
+        if (!Opressed) {
+            // gerado na primeira vez (~400 MB), depois reaproveitado
+            if (std::ifstream(BENCH_OBJ_PATH).good() || writeSyntheticOBJ(BENCH_OBJ_PATH, BENCH_OBJ_FACES))
+                benchmarkOBJLoaders(BENCH_OBJ_PATH);
+            Opressed = true;
+        }
+    }
+    else Opressed = false;
+
     static bool Lpressed = false;
     if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
         if (!Lpressed) {
             globalLightEnabled = !globalLightEnabled;
+            lightsDirty = true;
             Lpressed = true;
         }
     }
@@ -272,6 +563,7 @@ void processInput(GLFWwindow* window)
         if (glfwGetKey(window, key) == GLFW_PRESS) {
             if (!numPressed[i]) {
                 lightEnabled[i] = !lightEnabled[i];
+                lightsDirty = true;
                 numPressed[i] = true;
             }
         }
@@ -279,13 +571,19 @@ void processInput(GLFWwindow* window)
     }
 }
 
-GLuint loadShader(const char* vertPath, const char* fragPath)
+// Compila e linka o programa e resolve a tabela de uniforms (reflexo),
+// com os samplers j apontados para as unidades fixas de TextureArrays.
+// `defines` entra logo depois da linha #version das duas fontes.
+bool loadShader(const char* vertPath, const char* fragPath, ShaderProgram& out, const char* defines = "")
 {
     auto loadSrc = [&](const char* p) {
         std::ifstream f(p);
         if (!f.is_open()) return std::string();
         std::stringstream ss; ss << f.rdbuf();
-        return ss.str();
+        std::string src = ss.str();
+        size_t line = src.find('\n');
+        if (line != std::string::npos) src.insert(line + 1, defines);
+        return src;
         };
 
     std::string vCode = loadSrc(vertPath);
@@ -318,15 +616,26 @@ GLuint loadShader(const char* vertPath, const char* fragPath)
 
     glDeleteShader(v);
     glDeleteShader(f);
+    if (!ok) {
+        glDeleteProgram(prog);
+        return false;
+    }
+
+    reflectProgram(prog, out);
+    bindMaterialTable(prog);
+    bindFrameUniforms(prog);
 
-    return prog;
+    glUseProgram(prog);
+    bindTextureUnits(out);
+    glUseProgram(0);
+    return true;
 }
 
 int main()
 {
     if (!glfwInit()) return -1;
 
-    GLFWwindow* window = glfwCreateWindow(800, 600, "Trabalho Grau B", nullptr, nullptr);
+    GLFWwindow* window = glfwCreateWindow((int)SCREEN_WIDTH, (int)SCREEN_HEIGHT, "Trabalho Grau B", nullptr, nullptr);
     if (!window) return -1;
 
     glfwMakeContextCurrent(window);
@@ -341,10 +650,22 @@ int main()
 
     glEnable(GL_DEPTH_TEST);
 
-    shader = loadShader("Shaders/Core/core.vert", "Shaders/Core/core.frag");
-    if (shader == 0) return -1;
+    // BC1/BC3 com cache .dds quando o driver suporta S3TC
+    setTextureCompression(GLEW_EXT_texture_compression_s3tc != 0);
+
+    setTextureBudget(TEXTURE_BUDGET_MB * 1024 * 1024);
 
-    proj = glm::perspective(glm::radians(60.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    startAsyncLoader();
+
+    if (!loadShader("Shaders/Core/core.vert", "Shaders/Core/core.frag", shader)) return -1;
+
+    // GL 4.3+: mesmo core.frag, com material e hasTexCoords vindos do draw
+    if (indirectDrawSupported() &&
+        loadShader("Shaders/Core/core_indirect.vert", "Shaders/Core/core.frag", indirectShader, "#define INDIRECT_DRAW\n"))
+        useIndirectDraw = true;
+    std::cout << "[Render] Caminho " << (useIndirectDraw ? "multi-draw indireto (GL 4.3)" : "GL 3.3") << "\n";
+
+    proj = glm::perspective(glm::radians(FOV_DEGREES), SCREEN_WIDTH / SCREEN_HEIGHT, 0.1f, 100.0f);
 
     while (!glfwWindowShouldClose(window))
     {
@@ -354,6 +675,25 @@ int main()
 
         processInput(window);
 
+        // malhas e texturas ficam residentes aos poucos, sem travar o frame
+        runGLTasks(GL_UPLOAD_BUDGET_MS);
+        enforceTextureBudget();
+
+        static bool assetsLoading = false;
+        if (pendingLoads() > 0) assetsLoading = true;
+        else if (assetsLoading) {
+            assetsLoading = false;
+            printTextureCacheStats();
+        }
+
+        // pista e modelos parados vo para as pginas estticas uma vez,
+        // quando as malhas da cena esto todas residentes (ou falharam)
+        static bool staticBuilt = false;
+        if (scene && !staticBuilt && pendingLoads() == 0) {
+            buildStaticBatch(scene->objects);
+            staticBuilt = true;
+        }
+
         if (mode == MODE_EDITOR_2D)
         {
             glDisable(GL_DEPTH_TEST);
@@ -368,13 +708,11 @@ int main()
         }
 
         glEnable(GL_DEPTH_TEST);
-        glUseProgram(shader);
+        glUseProgram(shader.id);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         glm::mat4 view = camera.getViewMatrix();
-        glUniformMatrix4fv(glGetUniformLocation(shader, "proj"), 1, GL_FALSE, glm::value_ptr(proj));
-        glUniformMatrix4fv(glGetUniformLocation(shader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniform3fv(glGetUniformLocation(shader, "cameraPos"), 1, glm::value_ptr(camera.position));
+        updateFrameUniforms(view, proj, camera.position);
 
         if (!scene) {
             glfwSwapBuffers(window);
@@ -382,19 +720,20 @@ int main()
             continue;
         }
 
-        int count = std::min((int)scene->lights.size(), MAX_LIGHTS);
-        glUniform1i(glGetUniformLocation(shader, "lightCount"), count);
-        glUniform1i(glGetUniformLocation(shader, "globalLightEnabled"), globalLightEnabled);
+        // arrays de textura e atlas: uma vez por frame, nenhuma troca por grupo
+        bindTexturePages();
+        updateMaterialTable();
 
-        for (int i = 0; i < count; i++) {
-            std::string base = "lights[" + std::to_string(i) + "]";
-            glUniform3fv(glGetUniformLocation(shader, (base + ".position").c_str()), 1, glm::value_ptr(scene->lights[i].position));
-            glUniform3fv(glGetUniformLocation(shader, (base + ".color").c_str()), 1, glm::value_ptr(scene->lights[i].color));
-            glUniform1i(glGetUniformLocation(shader, ("lightEnabled[" + std::to_string(i) + "]").c_str()), lightEnabled[i] ? 1 : 0);
+        // luzes do scene.txt so estticas: bloco Lights s quando muda algo
+        if (lightsDirty) {
+            updateLightUniforms(scene->lights, lightEnabled, globalLightEnabled);
+            lightsDirty = false;
         }
 
-        if (!carPath.empty() && carTotalLength > 0.001f && carObj != nullptr)
+        if (!carPath.empty() && carTotalLength > 0.001f && carObj != nullptr && carObj->mesh != nullptr)
         {
+            carMinYLocal = carObj->mesh->boundsMin.y;
+
             carTravelS += carSpeed * deltaTime;
             while (carTravelS >= carTotalLength) carTravelS -= carTotalLength;
 
@@ -414,82 +753,47 @@ int main()
             carObj->transform = model;
         }
 
-        for (Obj3D* obj : scene->objects)
+        projectileManager.update(deltaTime, time);
+
+        // Objetos que compartilham a mesma malha viram um nico draw
+        // instanciado por grupo, com as matrizes model num VBO de instncias;
+        // o que est fora do frustum nem entra
+        glm::vec4 frustum[6];
+        camera.getFrustumPlanes(proj, frustum);
+        cullAndBatch(frustum);
+
+        // tudo passa pela fila: ordenado por programa/textura/material/VAO
+        // e desenhado sem repetir estado; no caminho indireto, um
+        // multi-draw por VAO
+        const ShaderProgram& drawShader = useIndirectDraw ? indirectShader : shader;
+        beginRenderQueue(view);
+
+        for (InstanceBatch& batch : instanceBatches)
         {
-            if (!obj || !obj->mesh || obj->mesh->groups.empty())
+            if (batch.models.empty())
                 continue;
 
-            glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(obj->transform));
-
-            Material defaultMat;
-            defaultMat.ka = glm::vec3(0.2f);
-            defaultMat.kd = glm::vec3(0.7f);
-            defaultMat.ks = glm::vec3(0.1f);
-            defaultMat.shininess = 16.0f;
-            defaultMat.hasTexture = false;
-
-            for (Group* g : obj->mesh->groups)
-            {
-                Material* mat = g->material ? g->material : &defaultMat;
-
-                glUniform3fv(glGetUniformLocation(shader, "material.ka"), 1, glm::value_ptr(mat->ka));
-                glUniform3fv(glGetUniformLocation(shader, "material.kd"), 1, glm::value_ptr(mat->kd));
-                glUniform3fv(glGetUniformLocation(shader, "material.ks"), 1, glm::value_ptr(mat->ks));
-                glUniform1f(glGetUniformLocation(shader, "material.shininess"), mat->shininess);
-                glUniform1i(glGetUniformLocation(shader, "material.hasTexture"), mat->hasTexture);
-
-                if (mat->hasTexture)
-                {
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(GL_TEXTURE_2D, mat->textureID);
-                    glUniform1i(glGetUniformLocation(shader, "texSampler"), 0);
-                }
-
-                glBindVertexArray(g->VAO);
-                glDrawArrays(GL_TRIANGLES, 0, g->numVertices);
-            }
+            for (size_t g = 0; g < batch.mesh->groups.size(); g++)
+                if (batch.groupVisible[g])
+                    submitInstanced(drawShader, batch.mesh, batch.mesh->groups[g], batch.lod,
+                        batch.models.data(), (int)batch.models.size());
         }
 
-		projectileManager.update(deltaTime, time);
-
-        if (projectileObj && projectileObj->mesh) {
-            for (Projectile& p : projectileManager.projectiles) {
-                glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(p.model));
-
-                Material defaultMat;
-                defaultMat.ka = glm::vec3(0.2f);
-                defaultMat.kd = glm::vec3(0.7f);
-                defaultMat.ks = glm::vec3(0.1f);
-                defaultMat.shininess = 16.0f;
-                defaultMat.hasTexture = false;
-
-                for (Group* g : projectileObj->mesh->groups)
-                {
-                    Material* mat = g->material ? g->material : &defaultMat;
-
-                    glUniform3fv(glGetUniformLocation(shader, "material.ka"), 1, glm::value_ptr(mat->ka));
-                    glUniform3fv(glGetUniformLocation(shader, "material.kd"), 1, glm::value_ptr(mat->kd));
-                    glUniform3fv(glGetUniformLocation(shader, "material.ks"), 1, glm::value_ptr(mat->ks));
-                    glUniform1f(glGetUniformLocation(shader, "material.shininess"), mat->shininess);
-                    glUniform1i(glGetUniformLocation(shader, "material.hasTexture"), mat->hasTexture);
-
-                    if (mat->hasTexture)
-                    {
-                        glActiveTexture(GL_TEXTURE0);
-                        glBindTexture(GL_TEXTURE_2D, mat->textureID);
-                        glUniform1i(glGetUniformLocation(shader, "texSampler"), 0);
-                    }
-
-                    glBindVertexArray(g->VAO);
-                    glDrawArrays(GL_TRIANGLES, 0, g->numVertices);
-                }
-            }
-        }
+        for (Group* d : visibleStaticDraws)
+            submitGroup(drawShader, d, 0, staticModel());
+
+        flushRenderQueue();
 
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
+    // cargas em andamento terminam (ou so descartadas) antes das liberaes
+    stopAsyncLoader();
+    releaseStaticBatch();
+    releaseScene(scene);
+    releaseMesh(projectileObj);
+    delete projectileObj;
     glfwTerminate();
     return 0;
 }